@@ -1,6 +1,17 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
 void GetAverageNoise(const std::vector<double>& noises_prefix,
@@ -38,12 +49,328 @@ std::vector<double> CreatePrefixArray(int entities_number) {
   return noises_prefix;
 }
 
+/*  Log-domain mode:
+ *   log_prefix[i] = log(noise_0) + ... + log(noise_{i-1}), so the average
+ *   noise on [left, right] is exp((log_prefix[right + 1] - log_prefix[left]) /
+ *   (right - left + 1)): one subtraction and one exp per request instead of
+ *   four pow calls.
+ */
+
+std::vector<double> CreateLogPrefixArray(int entities_number) {
+  std::vector<double> log_prefix(entities_number + 1);
+  log_prefix[0] = 0;
+
+  double noise_level;
+  for (int i = 1; i <= entities_number; ++i) {
+    std::cin >> noise_level;
+    log_prefix[i] = log_prefix[i - 1] + log(noise_level);
+  }
+
+  return log_prefix;
+}
+
+std::vector<double> ReadNoises(int entities_number) {
+  std::vector<double> noises(entities_number);
+  for (int i = 0; i < entities_number; ++i) {
+    std::cin >> noises[i];
+  }
+
+  return noises;
+}
+
+/*  Parallel scan: the input is split into one block per thread, every block
+ *   takes logarithms and builds its local prefix independently, then block
+ *   totals are scanned sequentially and each block adds its offset.
+ *   Only the summation order differs from CreateLogPrefixArray, so
+ *   |parallel[i] - sequential[i]| <= (threads_number + i) * eps * S_i, where
+ *   S_i = |log(noise_0)| + ... + |log(noise_{i-1})| — the same order as the
+ *   rounding error of the sequential scan itself. An answer on [l, r] then
+ *   differs relatively by at most 2 * that bound / (r - l + 1).
+ */
+
+std::vector<double> CreateLogPrefixArrayParallel(
+    const std::vector<double>& noises, size_t threads_number) {
+  size_t entities_number = noises.size();
+  std::vector<double> log_prefix(entities_number + 1);
+  log_prefix[0] = 0;
+
+  threads_number = std::max<size_t>(1, std::min(threads_number,
+                                                entities_number));
+  size_t block_size = (entities_number + threads_number - 1) / threads_number;
+  std::vector<double> block_offsets(threads_number + 1);
+
+  auto run_on_blocks = [&](auto block_function) {
+    std::vector<std::thread> threads;
+    for (size_t block = 0; block < threads_number; ++block) {
+      size_t begin = std::min(block * block_size, entities_number);
+      size_t end = std::min(begin + block_size, entities_number);
+      threads.emplace_back(block_function, block, begin, end);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  run_on_blocks([&](size_t block, size_t begin, size_t end) {
+    double sum = 0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += log(noises[i]);
+      log_prefix[i + 1] = sum;
+    }
+    block_offsets[block + 1] = sum;
+  });
+
+  for (size_t block = 1; block <= threads_number; ++block) {
+    block_offsets[block] += block_offsets[block - 1];
+  }
+
+  run_on_blocks([&](size_t block, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      log_prefix[i + 1] += block_offsets[block];
+    }
+  });
+
+  return log_prefix;
+}
+
+// Branchless exp: x = k * ln2 + r, |r| <= ln2 / 2, exp(r) by Taylor series of
+// degree 12 (relative error ~1e-16), 2^k is assembled in the exponent bits.
+// No calls and no branches, so loops over it are auto-vectorized. x must lie
+// in [-708, 709], which holds for any mean of logarithms of normal doubles.
+inline double VectorizableExp(double x) {
+  const double kLog2e = 1.4426950408889634;
+  const double kLn2Hi = 6.93147180369123816490e-01;
+  const double kLn2Lo = 1.90821492927058770002e-10;
+  const double kRoundMagic = 6755399441055744.0;  // 1.5 * 2^52
+  const int64_t kExpBias = 1023;
+  const int32_t kMantissaBits = 52;
+
+  double shifted = x * kLog2e + kRoundMagic;
+  double k = shifted - kRoundMagic;
+  double r = x - k * kLn2Hi - k * kLn2Lo;
+
+  double poly = 1.0 / 479001600;
+  poly = poly * r + 1.0 / 39916800;
+  poly = poly * r + 1.0 / 3628800;
+  poly = poly * r + 1.0 / 362880;
+  poly = poly * r + 1.0 / 40320;
+  poly = poly * r + 1.0 / 5040;
+  poly = poly * r + 1.0 / 720;
+  poly = poly * r + 1.0 / 120;
+  poly = poly * r + 1.0 / 24;
+  poly = poly * r + 1.0 / 6;
+  poly = poly * r + 1.0 / 2;
+  poly = poly * r + 1.0;
+  poly = poly * r + 1.0;
+
+  int64_t shifted_bits;
+  std::memcpy(&shifted_bits, &shifted, sizeof(shifted));
+  uint64_t scale_bits = static_cast<uint64_t>(shifted_bits + kExpBias)
+                        << kMantissaBits;
+  double scale;
+  std::memcpy(&scale, &scale_bits, sizeof(scale));
+
+  return poly * scale;
+}
+
+void GetAverageNoiseBatch(const std::vector<double>& log_prefix,
+                          const std::vector<int>& left_boarders,
+                          const std::vector<int>& right_boarders,
+                          std::vector<double>& result) {
+  const size_t kBlockSize = 256;
+
+  size_t requests_number = left_boarders.size();
+  result.resize(requests_number);
+
+  for (size_t begin = 0; begin < requests_number; begin += kBlockSize) {
+    size_t end = std::min(begin + kBlockSize, requests_number);
+
+    for (size_t i = begin; i < end; ++i) {
+      result[i] = (log_prefix[right_boarders[i] + 1] -
+                   log_prefix[left_boarders[i]]) /
+                  (right_boarders[i] - left_boarders[i] + 1);
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+      result[i] = VectorizableExp(result[i]);
+    }
+  }
+}
+
+void GetAverageNoiseLog(const std::vector<double>& log_prefix,
+                        int requests_number) {
+  const size_t kAfterCommaSigns = 10;
+
+  std::vector<int> left_boarders(requests_number);
+  std::vector<int> right_boarders(requests_number);
+  for (int i = 0; i < requests_number; ++i) {
+    std::cin >> left_boarders[i] >> right_boarders[i];
+  }
+
+  std::vector<double> result;
+  GetAverageNoiseBatch(log_prefix, left_boarders, right_boarders, result);
+
+  std::cout << std::fixed << std::setprecision(kAfterCommaSigns);
+  for (const auto& noise : result) {
+    std::cout << noise << '\n';
+  }
+}
+
+/*         PersistentPrefixStore
+*  Append-only log-domain prefix array kept in a memory-mapped file.
+*  Usage:
+*   Creation (creates the file or reopens it in O(1)):
+*    PersistentPrefixStore store(path);
+*   Operations:
+*    store.Append(noise_level)
+*    store.Size()
+*    store.GetAverageNoise(left_boarder, right_boarder)
+*/
+
+class PersistentPrefixStore {
+ public:
+  explicit PersistentPrefixStore(const std::string& path) {
+    file_descriptor_ = open(path.c_str(), O_RDWR | O_CREAT, kFileMode);
+    if (file_descriptor_ < 0) {
+      throw std::runtime_error("PersistentPrefixStore: cannot open " + path);
+    }
+
+    // The destructor does not run if the constructor throws.
+    try {
+      Load(path);
+    } catch (...) {
+      Unmap();
+      close(file_descriptor_);
+      throw;
+    }
+  }
+
+  PersistentPrefixStore(const PersistentPrefixStore&) = delete;
+  PersistentPrefixStore& operator=(const PersistentPrefixStore&) = delete;
+
+  ~PersistentPrefixStore() {
+    Unmap();
+    close(file_descriptor_);
+  }
+
+  void Append(double noise_level) {
+    if (header_->size + 1 >= Capacity()) {
+      Remap(2 * Capacity());
+    }
+
+    double* prefix = Prefix();
+    prefix[header_->size + 1] = prefix[header_->size] + log(noise_level);
+    ++header_->size;
+  }
+
+  size_t Size() const { return header_->size; }
+
+  double GetAverageNoise(size_t left_boarder, size_t right_boarder) const {
+    const double* prefix = Prefix();
+    return exp((prefix[right_boarder + 1] - prefix[left_boarder]) /
+               static_cast<double>(right_boarder - left_boarder + 1));
+  }
+
+ private:
+  struct Header {
+    uint64_t magic;
+    uint64_t size;
+  };
+
+  static constexpr uint64_t kMagic = 0x314270726566ULL;
+  static constexpr size_t kInitialCapacity = 1 << 16;
+  static constexpr mode_t kFileMode = 0644;
+
+  int file_descriptor_ = -1;
+  Header* header_ = nullptr;
+  size_t mapped_bytes_ = 0;
+
+  size_t Capacity() const {
+    return (mapped_bytes_ - sizeof(Header)) / sizeof(double);
+  }
+
+  double* Prefix() const { return reinterpret_cast<double*>(header_ + 1); }
+
+  void Load(const std::string& path) {
+    struct stat file_stat;
+    if (fstat(file_descriptor_, &file_stat) != 0) {
+      throw std::runtime_error("PersistentPrefixStore: cannot stat " + path);
+    }
+
+    if (static_cast<size_t>(file_stat.st_size) < sizeof(Header)) {
+      Remap(kInitialCapacity);
+      header_->magic = kMagic;
+      header_->size = 0;
+      Prefix()[0] = 0;
+      return;
+    }
+
+    MapFile(static_cast<size_t>(file_stat.st_size));
+    if (header_->magic != kMagic) {
+      throw std::runtime_error("PersistentPrefixStore: bad file " + path);
+    }
+    // A short or partly copied file: prefix[size] lies past its end.
+    if (header_->size >= Capacity()) {
+      throw std::runtime_error("PersistentPrefixStore: truncated file " +
+                               path);
+    }
+  }
+
+  void MapFile(size_t bytes) {
+    void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         file_descriptor_, 0);
+    if (address == MAP_FAILED) {
+      throw std::runtime_error("PersistentPrefixStore: mmap failed");
+    }
+
+    header_ = static_cast<Header*>(address);
+    mapped_bytes_ = bytes;
+  }
+
+  void Unmap() {
+    if (header_ != nullptr) {
+      munmap(header_, mapped_bytes_);
+      header_ = nullptr;
+    }
+  }
+
+  // The blocks are reserved before mapping, so a full disk is reported here
+  // instead of as SIGBUS on a later write through a sparse mapping. The old
+  // mapping is released only after the new one succeeds, so the store stays
+  // usable if growing fails.
+  void Remap(size_t capacity) {
+    size_t bytes = sizeof(Header) + capacity * sizeof(double);
+    if (posix_fallocate(file_descriptor_, 0, static_cast<off_t>(bytes)) !=
+        0) {
+      throw std::runtime_error("PersistentPrefixStore: cannot grow file");
+    }
+
+    Header* old_header = header_;
+    size_t old_bytes = mapped_bytes_;
+    MapFile(bytes);
+    if (old_header != nullptr) {
+      munmap(old_header, old_bytes);
+    }
+  }
+};
+
+void StreamSpedUp() {
+  std::ios_base::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+  std::cout.tie(nullptr);
+}
+
 int main() {
+  StreamSpedUp();
+
   int entities_number;
   int requests_number;
 
   std::cin >> entities_number >> requests_number;
 
-  GetAverageNoise(CreatePrefixArray(entities_number), requests_number);
+  GetAverageNoiseLog(
+      CreateLogPrefixArrayParallel(ReadNoises(entities_number),
+                                   std::thread::hardware_concurrency()),
+      requests_number);
   return 0;
 }
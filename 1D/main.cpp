@@ -1,45 +1,184 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
-bool MinDistanceHelper(const std::vector<int>& places_coors,
-                       int entities_numbers, int distance) {
+enum class FeasibilityStrategy { kLinear, kGalloping, kAuto };
+
+// Number of entities placed greedily with the given distance, capped by limit.
+int CountPlaces(const std::vector<int>& places_coors, int distance,
+                int limit) {
   int current_place = places_coors[0];
   int counter = 1;
 
-  for (size_t i = 1; i < places_coors.size(); ++i) {
+  for (size_t i = 1; i < places_coors.size() && counter < limit; ++i) {
     if (places_coors[i] - current_place >= distance) {
       current_place = places_coors[i];
       ++counter;
     }
   }
 
-  return counter >= entities_numbers;
+  return counter;
+}
+
+// First index in (from, size) with places_coors[index] >= target or size if
+// there is none. Galloping finds a range of width 2^j, then a branchless
+// binary search narrows it: O(log(index - from)) comparisons.
+size_t NextPlace(const std::vector<int>& places_coors, size_t from,
+                 int target) {
+  size_t size = places_coors.size();
+  size_t step = 1;
+
+  while (from + step < size && places_coors[from + step] < target) {
+    step *= 2;
+  }
+
+  size_t base = from + step / 2;
+  size_t length = std::min(from + step, size - 1) - base;
+  while (length > 0) {
+    size_t half = (length + 1) / 2;
+    base += (places_coors[base + half] < target) ? half : 0;
+    length -= half;
+  }
+
+  if (places_coors[base] < target) {
+    ++base;
+  }
+  return base;
+}
+
+int CountPlacesGalloping(const std::vector<int>& places_coors, int distance,
+                         int limit) {
+  size_t current_index = 0;
+  int counter = 1;
+
+  while (counter < limit) {
+    current_index = NextPlace(places_coors, current_index,
+                              places_coors[current_index] + distance);
+    if (current_index == places_coors.size()) {
+      break;
+    }
+    ++counter;
+  }
+
+  return counter;
+}
+
+// Galloping costs O(k log n) per check against O(n) for the linear scan.
+FeasibilityStrategy ChooseStrategy(size_t places_number,
+                                   int entities_numbers) {
+  double galloping_cost =
+      entities_numbers * (std::log2(static_cast<double>(places_number)) + 1);
+  return galloping_cost < places_number ? FeasibilityStrategy::kGalloping
+                                        : FeasibilityStrategy::kLinear;
+}
+
+int CountPlaces(const std::vector<int>& places_coors, int distance, int limit,
+                FeasibilityStrategy strategy) {
+  if (strategy == FeasibilityStrategy::kAuto) {
+    strategy = ChooseStrategy(places_coors.size(), limit);
+  }
+
+  if (strategy == FeasibilityStrategy::kGalloping) {
+    return CountPlacesGalloping(places_coors, distance, limit);
+  }
+  return CountPlaces(places_coors, distance, limit);
+}
+
+bool IsFeasible(const std::vector<int>& places_coors, int entities_numbers,
+                int distance, FeasibilityStrategy strategy) {
+  return CountPlaces(places_coors, distance, entities_numbers, strategy) >=
+         entities_numbers;
 }
 
 void MinDistance(const std::vector<int>& places_coors, int entities_numbers,
-                 int left_boarder, int right_boarder, int& max_distance) {
+                 int left_boarder, int right_boarder, int& max_distance,
+                 FeasibilityStrategy strategy = FeasibilityStrategy::kAuto) {
   if (right_boarder - left_boarder <= 1) {
-    if (MinDistanceHelper(places_coors, entities_numbers, left_boarder)) {
+    if (IsFeasible(places_coors, entities_numbers, left_boarder, strategy)) {
       max_distance = left_boarder;
-    } else if (MinDistanceHelper(places_coors, entities_numbers,
-                                 right_boarder)) {
+    } else if (IsFeasible(places_coors, entities_numbers, right_boarder,
+                          strategy)) {
       max_distance = right_boarder;
     }
     return;
   }
 
-  if (MinDistanceHelper(places_coors, entities_numbers,
-                        (left_boarder + right_boarder) / 2)) {
+  if (IsFeasible(places_coors, entities_numbers,
+                 (left_boarder + right_boarder) / 2, strategy)) {
     max_distance = (left_boarder + right_boarder) / 2;
     MinDistance(places_coors, entities_numbers,
                 (left_boarder + right_boarder) / 2, right_boarder,
-                max_distance);
+                max_distance, strategy);
   } else {
     MinDistance(places_coors, entities_numbers, left_boarder,
-                (left_boarder + right_boarder) / 2, max_distance);
+                (left_boarder + right_boarder) / 2, max_distance, strategy);
   }
 }
 
+/*  Batch mode: the answer is non-increasing in the number of entities, so all
+ *   requested k are searched together. One check at distance mid returns the
+ *   greedy count c (capped by the largest k in the group) and splits the
+ *   sorted group: k <= c go to [mid, right], the rest to [left, mid - 1].
+ *   Groups share checks until they separate, so close k cost about one search.
+ */
+
+void MinDistanceBatchHelper(const std::vector<int>& places_coors,
+                            const std::vector<int>& sorted_entities,
+                            size_t first, size_t last, int left_boarder,
+                            int right_boarder, std::vector<int>& answers,
+                            FeasibilityStrategy strategy) {
+  if (first == last) {
+    return;
+  }
+
+  if (left_boarder == right_boarder) {
+    for (size_t i = first; i < last; ++i) {
+      answers[i] = left_boarder;
+    }
+    return;
+  }
+
+  int middle = left_boarder + (right_boarder - left_boarder + 1) / 2;
+  int counter = CountPlaces(places_coors, middle, sorted_entities[last - 1],
+                            strategy);
+  size_t bound = std::upper_bound(sorted_entities.begin() + first,
+                                  sorted_entities.begin() + last, counter) -
+                 sorted_entities.begin();
+
+  MinDistanceBatchHelper(places_coors, sorted_entities, first, bound, middle,
+                         right_boarder, answers, strategy);
+  MinDistanceBatchHelper(places_coors, sorted_entities, bound, last,
+                         left_boarder, middle - 1, answers, strategy);
+}
+
+std::vector<int> MinDistanceBatch(
+    const std::vector<int>& places_coors,
+    const std::vector<int>& entities_numbers,
+    FeasibilityStrategy strategy = FeasibilityStrategy::kAuto) {
+  std::vector<int> sorted_entities = entities_numbers;
+  std::sort(sorted_entities.begin(), sorted_entities.end());
+  sorted_entities.erase(
+      std::unique(sorted_entities.begin(), sorted_entities.end()),
+      sorted_entities.end());
+
+  std::vector<int> sorted_answers(sorted_entities.size());
+  MinDistanceBatchHelper(
+      places_coors, sorted_entities, 0, sorted_entities.size(), 1,
+      std::max(places_coors.back() - places_coors.front(), 1), sorted_answers,
+      strategy);
+
+  std::vector<int> answers(entities_numbers.size());
+  for (size_t i = 0; i < entities_numbers.size(); ++i) {
+    answers[i] = sorted_answers[std::lower_bound(sorted_entities.begin(),
+                                                 sorted_entities.end(),
+                                                 entities_numbers[i]) -
+                                sorted_entities.begin()];
+  }
+
+  return answers;
+}
+
 int main() {
   int places_number;
   int entities_number;
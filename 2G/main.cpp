@@ -1,4 +1,18 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 const size_t kSize = 5;
@@ -14,6 +28,130 @@ void BubbleSort(std::vector<T>& array, size_t size = kSize) {
   }
 }
 
+/*  Sorting networks: fixed sequences of compare-exchanges (optimal for 3, 5,
+ *   7 and 9 elements). A compare-exchange is a min/max pair without branches.
+ *   SortGroup<Size> picks the network at compile time and falls back to
+ *   bubble sort for other sizes. SortGroups sorts many consecutive groups at
+ *   once: kLanes groups are transposed so that every compare-exchange becomes
+ *   an element-wise min/max over kLanes values, which the compiler vectorizes.
+ */
+
+template <size_t Size>
+struct SortingNetwork {
+  static constexpr std::array<std::pair<size_t, size_t>, 0> kComparators{};
+};
+
+template <>
+struct SortingNetwork<3> {
+  static constexpr std::array<std::pair<size_t, size_t>, 3> kComparators{
+      {{0, 2}, {0, 1}, {1, 2}}};
+};
+
+template <>
+struct SortingNetwork<5> {
+  static constexpr std::array<std::pair<size_t, size_t>, 9> kComparators{
+      {{0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3}}};
+};
+
+template <>
+struct SortingNetwork<7> {
+  static constexpr std::array<std::pair<size_t, size_t>, 16> kComparators{
+      {{0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5},
+       {3, 4}, {1, 2}, {4, 6}, {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6}}};
+};
+
+template <>
+struct SortingNetwork<9> {
+  static constexpr std::array<std::pair<size_t, size_t>, 25> kComparators{
+      {{0, 3}, {1, 7}, {2, 5}, {4, 8}, {0, 7}, {2, 4}, {3, 8}, {5, 6}, {0, 2},
+       {1, 3}, {4, 5}, {7, 8}, {1, 4}, {3, 6}, {5, 7}, {0, 1}, {2, 4}, {3, 5},
+       {6, 8}, {2, 3}, {4, 5}, {6, 7}, {1, 2}, {3, 4}, {5, 6}}};
+};
+
+template <typename T>
+void CompareExchange(T& first, T& second) {
+  T min = second < first ? second : first;
+  T max = second < first ? first : second;
+  first = min;
+  second = max;
+}
+
+template <size_t Size, typename T>
+void SortGroup(T* group) {
+  constexpr auto& kComparators = SortingNetwork<Size>::kComparators;
+
+  if constexpr (kComparators.empty()) {
+    for (size_t i = 0; i + 1 < Size; ++i) {
+      for (size_t j = 0; j + i + 1 < Size; ++j) {
+        if (group[j] > group[j + 1]) {
+          std::swap(group[j], group[j + 1]);
+        }
+      }
+    }
+  } else {
+    for (const auto& [first, second] : kComparators) {
+      CompareExchange(group[first], group[second]);
+    }
+  }
+}
+
+const size_t kLanes = 32;
+
+template <size_t First, size_t Second, typename T, size_t Size>
+void CompareExchangeLanes(T (&lanes)[Size][kLanes]) {
+  T* first_row = lanes[First];
+  T* second_row = lanes[Second];
+
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    T first = first_row[lane];
+    T second = second_row[lane];
+    first_row[lane] = second < first ? second : first;
+    second_row[lane] = second < first ? first : second;
+  }
+}
+
+template <size_t Size, typename T, size_t... Indices>
+void SortLanes(T (&lanes)[Size][kLanes], std::index_sequence<Indices...>) {
+  constexpr auto& kComparators = SortingNetwork<Size>::kComparators;
+
+  (CompareExchangeLanes<kComparators[Indices].first,
+                        kComparators[Indices].second>(lanes),
+   ...);
+}
+
+// Sorts groups_number consecutive groups of Size elements starting at values.
+template <size_t Size, typename T>
+void SortGroups(T* values, size_t groups_number) {
+  constexpr auto& kComparators = SortingNetwork<Size>::kComparators;
+
+  size_t group = 0;
+  if constexpr (std::is_arithmetic_v<T> && !kComparators.empty()) {
+    T lanes[Size][kLanes];
+
+    for (; group + kLanes <= groups_number; group += kLanes) {
+      T* block = values + group * Size;
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        for (size_t i = 0; i < Size; ++i) {
+          lanes[i][lane] = block[lane * Size + i];
+        }
+      }
+
+      SortLanes<Size>(lanes,
+                      std::make_index_sequence<kComparators.size()>());
+
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        for (size_t i = 0; i < Size; ++i) {
+          block[lane * Size + i] = lanes[i][lane];
+        }
+      }
+    }
+  }
+
+  for (; group < groups_number; ++group) {
+    SortGroup<Size>(values + group * Size);
+  }
+}
+
 template <typename T>
 T ChoosePivot(std::vector<T>& array) {
   if (array.size() <= kSize) {
@@ -29,7 +167,7 @@ T ChoosePivot(std::vector<T>& array) {
       current_array[j] = array[kSize * i + j];
     }
 
-    BubbleSort(current_array);
+    SortGroup<kSize>(current_array.data());
     medians_array[i] = current_array[kSize / 2];
   }
 
@@ -139,7 +277,595 @@ void QuickSort(std::vector<T>& array, size_t left, size_t right) {
   QuickSort(array, bound + 1, right);
 }
 
+/*  In-place mode: every function works on the half-open range
+ *   [begin, end) of the original array and allocates nothing. Medians of the
+ *   groups of five are swapped to the front of the range and selected there
+ *   recursively; partitioning is a single three-way pass. Pivots are exact
+ *   medians, so QuickSortInPlace stays O(n log n) in the worst case.
+ */
+
+template <typename T>
+void InsertionSort(std::vector<T>& array, size_t begin, size_t end) {
+  for (size_t i = begin + 1; i < end; ++i) {
+    T current = std::move(array[i]);
+    size_t j = i;
+    for (; j > begin && current < array[j - 1]; --j) {
+      array[j] = std::move(array[j - 1]);
+    }
+    array[j] = std::move(current);
+  }
+}
+
+// Dutch national flag partition: after it [begin, first) < pivot,
+// [first, second) == pivot and [second, end) > pivot.
+template <typename T>
+std::pair<size_t, size_t> ThreeWayPartition(std::vector<T>& array,
+                                            size_t begin, size_t end,
+                                            const T& pivot) {
+  size_t less_end = begin;
+  size_t current = begin;
+  size_t greater_begin = end;
+
+  while (current < greater_begin) {
+    if (array[current] < pivot) {
+      std::swap(array[less_end++], array[current++]);
+    } else if (pivot < array[current]) {
+      std::swap(array[current], array[--greater_begin]);
+    } else {
+      ++current;
+    }
+  }
+
+  return std::pair(less_end, greater_begin);
+}
+
+template <typename T>
+T SelectInPlace(std::vector<T>& array, size_t begin, size_t end,
+                size_t kth_stat);
+
+template <typename T>
+T ChoosePivotInPlace(std::vector<T>& array, size_t begin, size_t end) {
+  size_t groups_number = (end - begin) / kSize;
+
+  SortGroups<kSize>(array.data() + begin, groups_number);
+  for (size_t i = 0; i < groups_number; ++i) {
+    std::swap(array[begin + i], array[begin + kSize * i + kSize / 2]);
+  }
+
+  return SelectInPlace(array, begin, begin + groups_number,
+                       groups_number / 2);
+}
+
+// kth_stat is 0-based here, the copying KthStat above counts from 1.
+template <typename T>
+T SelectInPlace(std::vector<T>& array, size_t begin, size_t end,
+                size_t kth_stat) {
+  while (end - begin > kSize) {
+    T pivot = ChoosePivotInPlace(array, begin, end);
+    auto [less_end, greater_begin] =
+        ThreeWayPartition(array, begin, end, pivot);
+
+    if (begin + kth_stat < less_end) {
+      end = less_end;
+    } else if (begin + kth_stat < greater_begin) {
+      return pivot;
+    } else {
+      kth_stat -= greater_begin - begin;
+      begin = greater_begin;
+    }
+  }
+
+  InsertionSort(array, begin, end);
+  return array[begin + kth_stat];
+}
+
+template <typename T>
+void QuickSortInPlace(std::vector<T>& array, size_t begin, size_t end) {
+  while (end - begin > kSize) {
+    T pivot = SelectInPlace(array, begin, end, (end - begin) / 2);
+    auto [less_end, greater_begin] =
+        ThreeWayPartition(array, begin, end, pivot);
+
+    if (less_end - begin < end - greater_begin) {
+      QuickSortInPlace(array, begin, less_end);
+      begin = greater_begin;
+    } else {
+      QuickSortInPlace(array, greater_begin, end);
+      end = less_end;
+    }
+  }
+
+  InsertionSort(array, begin, end);
+}
+
+/*  Block partition (BlockQuicksort): instead of branching on every
+ *   comparison, a block of kPartitionBlockSize elements from each end is
+ *   scanned and the offsets of misplaced elements are written
+ *   unconditionally, the counter grows by the comparison result. Misplaced
+ *   pairs are then swapped in bulk. The unprocessed middle (at most two
+ *   blocks) is finished by a plain loop. Elements satisfying goes_left end up
+ *   in [begin, result), the others in [result, end).
+ */
+
+const size_t kPartitionBlockSize = 128;
+
+enum class PartitionMode { kThreeWay, kBlock };
+
+template <typename T, typename Predicate>
+size_t BlockPartition(std::vector<T>& array, size_t begin, size_t end,
+                      Predicate goes_left) {
+  uint8_t left_offsets[kPartitionBlockSize];
+  uint8_t right_offsets[kPartitionBlockSize];
+  size_t left_count = 0;
+  size_t left_start = 0;
+  size_t right_count = 0;
+  size_t right_start = 0;
+
+  size_t left = begin;
+  size_t right = end;
+  while (right - left > 2 * kPartitionBlockSize) {
+    if (left_count == 0) {
+      left_start = 0;
+      for (size_t i = 0; i < kPartitionBlockSize; ++i) {
+        left_offsets[left_count] = static_cast<uint8_t>(i);
+        left_count += !goes_left(array[left + i]);
+      }
+    }
+    if (right_count == 0) {
+      right_start = 0;
+      for (size_t i = 0; i < kPartitionBlockSize; ++i) {
+        right_offsets[right_count] = static_cast<uint8_t>(i);
+        right_count += goes_left(array[right - 1 - i]);
+      }
+    }
+
+    size_t swaps_number = std::min(left_count, right_count);
+    for (size_t i = 0; i < swaps_number; ++i) {
+      std::swap(array[left + left_offsets[left_start + i]],
+                array[right - 1 - right_offsets[right_start + i]]);
+    }
+
+    left_count -= swaps_number;
+    right_count -= swaps_number;
+    left_start += swaps_number;
+    right_start += swaps_number;
+    if (left_count == 0) {
+      left += kPartitionBlockSize;
+    }
+    if (right_count == 0) {
+      right -= kPartitionBlockSize;
+    }
+  }
+
+  while (left < right) {
+    if (goes_left(array[left])) {
+      ++left;
+    } else {
+      std::swap(array[left], array[--right]);
+    }
+  }
+
+  return left;
+}
+
+/*  Hybrid mode (introsort style): pivots are cheap ninthers (median of three
+ *   medians of three), ranges of at most kInsertionSortSize elements are
+ *   finished by insertion sort. A partition whose smaller side is less than
+ *   1/kImbalanceRatio of the range is bad; after log2(n) bad partitions the
+ *   range switches to the exact median from SelectInPlace. There are at most
+ *   log2(n) linear bad levels, so the worst case stays O(n log n).
+ */
+
+const size_t kInsertionSortSize = 24;
+const size_t kNintherSize = 128;
+const size_t kImbalanceRatio = 8;
+
+// Same contract as ThreeWayPartition. The block mode splits off elements
+// equal to the pivot with a second pass only when the first pass leaves the
+// right part too large, i.e. when the range is rich in duplicates.
+template <typename T>
+std::pair<size_t, size_t> PartitionAround(std::vector<T>& array, size_t begin,
+                                          size_t end, const T& pivot,
+                                          PartitionMode mode) {
+  if (mode == PartitionMode::kThreeWay) {
+    return ThreeWayPartition(array, begin, end, pivot);
+  }
+
+  size_t size = end - begin;
+  size_t less_end = BlockPartition(
+      array, begin, end, [&pivot](const T& elem) { return elem < pivot; });
+
+  size_t greater_begin = less_end;
+  if (end - less_end > size - size / kImbalanceRatio) {
+    greater_begin =
+        BlockPartition(array, less_end, end,
+                       [&pivot](const T& elem) { return !(pivot < elem); });
+  }
+
+  return std::pair(less_end, greater_begin);
+}
+
+template <typename T>
+size_t MedianOfThree(const std::vector<T>& array, size_t first, size_t second,
+                     size_t third) {
+  if (array[second] < array[first]) {
+    std::swap(first, second);
+  }
+  if (array[third] < array[second]) {
+    second = (array[third] < array[first]) ? first : third;
+  }
+  return second;
+}
+
+template <typename T>
+T ChooseNinther(const std::vector<T>& array, size_t begin, size_t end) {
+  size_t size = end - begin;
+  size_t middle = begin + size / 2;
+
+  if (size < kNintherSize) {
+    return array[MedianOfThree(array, begin, middle, end - 1)];
+  }
+
+  size_t step = size / 8;
+  return array[MedianOfThree(
+      array, MedianOfThree(array, begin, begin + step, begin + 2 * step),
+      MedianOfThree(array, middle - step, middle, middle + step),
+      MedianOfThree(array, end - 1 - 2 * step, end - 1 - step, end - 1))];
+}
+
+template <typename T>
+void HybridQuickSortHelper(std::vector<T>& array, size_t begin, size_t end,
+                           size_t bad_partitions_allowed, PartitionMode mode) {
+  while (end - begin > kInsertionSortSize) {
+    size_t size = end - begin;
+    T pivot = (bad_partitions_allowed > 0)
+                  ? ChooseNinther(array, begin, end)
+                  : SelectInPlace(array, begin, end, size / 2);
+    auto [less_end, greater_begin] =
+        PartitionAround(array, begin, end, pivot, mode);
+
+    size_t less_size = less_end - begin;
+    size_t greater_size = end - greater_begin;
+    if (std::min(less_size, greater_size) < size / kImbalanceRatio &&
+        bad_partitions_allowed > 0) {
+      --bad_partitions_allowed;
+    }
+
+    if (less_size < greater_size) {
+      HybridQuickSortHelper(array, begin, less_end, bad_partitions_allowed,
+                            mode);
+      begin = greater_begin;
+    } else {
+      HybridQuickSortHelper(array, greater_begin, end, bad_partitions_allowed,
+                            mode);
+      end = less_end;
+    }
+  }
+
+  InsertionSort(array, begin, end);
+}
+
+size_t BadPartitionsBudget(size_t size) {
+  size_t bad_partitions_allowed = 0;
+  for (; size > 1; size /= 2) {
+    ++bad_partitions_allowed;
+  }
+  return bad_partitions_allowed;
+}
+
+template <typename T>
+void HybridQuickSort(std::vector<T>& array, size_t begin, size_t end,
+                     PartitionMode mode = PartitionMode::kBlock) {
+  HybridQuickSortHelper(array, begin, end, BadPartitionsBudget(end - begin),
+                        mode);
+}
+
+/*         WorkStealingPool
+*  Every worker owns a deque: it pushes and pops its own tasks at the back
+*  (LIFO, good locality for recursive tasks) and steals from the front of
+*  the others when its deque is empty. Tasks are grouped by TaskGroup;
+*  Wait(group) runs pending tasks on the calling thread until the group is
+*  done, so waiting inside a task never blocks a worker.
+*  Usage:
+*   Creation:
+*    WorkStealingPool pool(threads_number);
+*    WorkStealingPool::TaskGroup group;
+*   Operations:
+*    pool.Submit(group, task)
+*    pool.Wait(group)
+*/
+
+class WorkStealingPool {
+ public:
+  struct TaskGroup {
+    std::atomic<size_t> pending = 0;
+  };
+
+  explicit WorkStealingPool(size_t threads_number)
+      : queues_(std::max<size_t>(1, threads_number)) {
+    for (size_t i = 0; i < queues_.size(); ++i) {
+      workers_.emplace_back([this, i] {
+        current_pool_ = this;
+        worker_index_ = i;
+        while (!stop_.load(std::memory_order_acquire)) {
+          if (!TryRunTask()) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  ~WorkStealingPool() {
+    stop_.store(true, std::memory_order_release);
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  size_t Size() const { return queues_.size(); }
+
+  void Submit(TaskGroup& group, std::function<void()> task) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+
+    size_t index = (current_pool_ == this)
+                       ? worker_index_
+                       : next_queue_.fetch_add(1) % queues_.size();
+    std::lock_guard<std::mutex> lock(queues_[index].mutex);
+    queues_[index].tasks.emplace_back([&group, task = std::move(task)] {
+      task();
+      group.pending.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  void Wait(TaskGroup& group) {
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+      if (!TryRunTask()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  static thread_local WorkStealingPool* current_pool_;
+  static thread_local size_t worker_index_;
+
+  std::vector<Queue> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> next_queue_ = 0;
+  std::atomic<bool> stop_ = false;
+
+  bool TryRunTask() {
+    bool is_worker = (current_pool_ == this);
+    size_t own_index = is_worker ? worker_index_ : 0;
+    std::function<void()> task;
+
+    for (size_t shift = 0; shift < queues_.size() && !task; ++shift) {
+      Queue& queue = queues_[(own_index + shift) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) {
+        continue;
+      }
+
+      if (is_worker && shift == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+    }
+
+    if (!task) {
+      return false;
+    }
+    task();
+    return true;
+  }
+};
+
+thread_local WorkStealingPool* WorkStealingPool::current_pool_ = nullptr;
+thread_local size_t WorkStealingPool::worker_index_ = 0;
+
+/*  Parallel mode: ranges longer than kParallelCutoff spawn both recursive
+ *   calls as pool tasks, shorter ones are sorted by HybridQuickSortHelper.
+ *   Ranges longer than kParallelPartitionSize are also partitioned in
+ *   parallel: every chunk is block-partitioned by its own task, then
+ *   neighbouring chunks are merged pairwise in log(chunks) parallel rounds
+ *   by rotating the right part of one chunk with the left part of the next.
+ *   Pivots and partitions depend only on the data, so the output is the same
+ *   as in the sequential modes.
+ */
+
+const size_t kParallelCutoff = 1 << 16;
+const size_t kParallelPartitionSize = 1 << 22;
+
+template <typename T, typename Predicate>
+size_t ParallelBlockPartition(std::vector<T>& array, size_t begin, size_t end,
+                              Predicate goes_left, WorkStealingPool& pool) {
+  struct Piece {
+    size_t begin;
+    size_t split;
+    size_t end;
+  };
+
+  size_t chunks_number = pool.Size();
+  size_t chunk_size = (end - begin + chunks_number - 1) / chunks_number;
+  std::vector<Piece> pieces(chunks_number);
+  WorkStealingPool::TaskGroup group;
+
+  for (size_t i = 0; i < chunks_number; ++i) {
+    size_t chunk_begin = std::min(begin + i * chunk_size, end);
+    size_t chunk_end = std::min(chunk_begin + chunk_size, end);
+    pool.Submit(group, [&array, &pieces, &goes_left, i, chunk_begin,
+                        chunk_end] {
+      pieces[i] = {chunk_begin,
+                   BlockPartition(array, chunk_begin, chunk_end, goes_left),
+                   chunk_end};
+    });
+  }
+  pool.Wait(group);
+
+  while (pieces.size() > 1) {
+    std::vector<Piece> merged((pieces.size() + 1) / 2);
+    for (size_t i = 0; i < merged.size(); ++i) {
+      if (2 * i + 1 == pieces.size()) {
+        merged[i] = pieces[2 * i];
+        continue;
+      }
+
+      Piece left = pieces[2 * i];
+      Piece right = pieces[2 * i + 1];
+      merged[i] = {left.begin,
+                   left.split + (right.split - right.begin), right.end};
+      pool.Submit(group, [&array, left, right] {
+        std::rotate(array.begin() + left.split, array.begin() + right.begin,
+                    array.begin() + right.split);
+      });
+    }
+    pool.Wait(group);
+    pieces = std::move(merged);
+  }
+
+  return pieces[0].split;
+}
+
+template <typename T>
+void ParallelQuickSortHelper(std::vector<T>& array, size_t begin, size_t end,
+                             size_t bad_partitions_allowed,
+                             WorkStealingPool& pool,
+                             WorkStealingPool::TaskGroup& group) {
+  size_t size = end - begin;
+  if (size <= kParallelCutoff) {
+    HybridQuickSortHelper(array, begin, end, bad_partitions_allowed,
+                          PartitionMode::kBlock);
+    return;
+  }
+
+  T pivot = (bad_partitions_allowed > 0)
+                ? ChooseNinther(array, begin, end)
+                : SelectInPlace(array, begin, end, size / 2);
+
+  size_t less_end;
+  size_t greater_begin;
+  if (size < kParallelPartitionSize) {
+    std::tie(less_end, greater_begin) =
+        PartitionAround(array, begin, end, pivot, PartitionMode::kBlock);
+  } else {
+    less_end = ParallelBlockPartition(
+        array, begin, end, [&pivot](const T& elem) { return elem < pivot; },
+        pool);
+    greater_begin = less_end;
+    if (end - less_end > size - size / kImbalanceRatio) {
+      greater_begin = ParallelBlockPartition(
+          array, less_end, end,
+          [&pivot](const T& elem) { return !(pivot < elem); }, pool);
+    }
+  }
+
+  if (std::min(less_end - begin, end - greater_begin) <
+          size / kImbalanceRatio &&
+      bad_partitions_allowed > 0) {
+    --bad_partitions_allowed;
+  }
+
+  pool.Submit(group, [&array, &pool, &group, begin, less_end,
+                      bad_partitions_allowed] {
+    ParallelQuickSortHelper(array, begin, less_end, bad_partitions_allowed,
+                            pool, group);
+  });
+  pool.Submit(group, [&array, &pool, &group, greater_begin, end,
+                      bad_partitions_allowed] {
+    ParallelQuickSortHelper(array, greater_begin, end, bad_partitions_allowed,
+                            pool, group);
+  });
+}
+
+template <typename T>
+void ParallelQuickSort(std::vector<T>& array, size_t begin, size_t end,
+                       size_t threads_number) {
+  if (threads_number <= 1 || end - begin <= kParallelCutoff) {
+    HybridQuickSort(array, begin, end);
+    return;
+  }
+
+  WorkStealingPool pool(threads_number);
+  WorkStealingPool::TaskGroup group;
+  ParallelQuickSortHelper(array, begin, end, BadPartitionsBudget(end - begin),
+                          pool, group);
+  pool.Wait(group);
+}
+
+/*  Benchmark (compile with -DSORT_BENCHMARK): sorts kBenchmarkSize int32_t
+ *   with both partition modes and with the parallel mode on random, sorted
+ *   and many-duplicates inputs.
+ */
+
+void BenchmarkSort(const std::string& input_name,
+                   const std::vector<int32_t>& input) {
+  using Clock = std::chrono::steady_clock;
+
+  for (auto [mode, mode_name] :
+       {std::pair(PartitionMode::kThreeWay, "three-way"),
+        std::pair(PartitionMode::kBlock, "block")}) {
+    std::vector<int32_t> array = input;
+
+    auto start = Clock::now();
+    HybridQuickSort(array, 0, array.size(), mode);
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << input_name << ", " << mode_name << ": " << seconds << " s\n";
+  }
+
+  std::vector<int32_t> array = input;
+  size_t threads_number = std::thread::hardware_concurrency();
+
+  auto start = Clock::now();
+  ParallelQuickSort(array, 0, array.size(), threads_number);
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::cout << input_name << ", parallel (" << threads_number
+            << " threads): " << seconds << " s\n";
+}
+
+void RunSortBenchmarks() {
+  const size_t kBenchmarkSize = 100000000;
+  const uint32_t kDistinctValues = 16;
+
+  std::mt19937 generator(kBenchmarkSize);
+  std::vector<int32_t> input(kBenchmarkSize);
+
+  for (auto& number : input) {
+    number = static_cast<int32_t>(generator());
+  }
+  BenchmarkSort("random", input);
+
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<int32_t>(i);
+  }
+  BenchmarkSort("sorted", input);
+
+  for (auto& number : input) {
+    number = static_cast<int32_t>(generator() % kDistinctValues);
+  }
+  BenchmarkSort("many duplicates", input);
+}
+
 int main() {
+#ifdef SORT_BENCHMARK
+  RunSortBenchmarks();
+  return 0;
+#endif
+
   size_t array_size;
   std::cin >> array_size;
 
@@ -148,7 +874,8 @@ int main() {
     std::cin >> array[i];
   }
 
-  QuickSort(array, 0, array.size() - 1);
+  ParallelQuickSort(array, 0, array.size(),
+                    std::thread::hardware_concurrency());
   for (auto& number : array) {
     std::cout << number << " ";
   }
@@ -1,4 +1,11 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <thread>
+#include <utility>
 #include <vector>
 
 template <typename T>
@@ -43,11 +50,575 @@ T KthStat(std::vector<T>& array, size_t left, size_t right, size_t kth_stat) {
   return KthStat(array, bound + 1, right, kth_stat - (bound - left + 1));
 }
 
-int main() {
-  const int32_t kXcoef = 123;
-  const int32_t kYcoef = 45;
-  const int32_t kMod = 10004321;
+/*  Floyd–Rivest selection: a random-free sample of about n^(2/3) elements
+ *   around the expected position of the answer is selected recursively, so
+ *   the pivot lies just next to the k-th element and the next range is small.
+ *   It takes about n + min(k, n - k) comparisons on average. Introselect
+ *   fallback: every partition pass is charged its range size against a
+ *   budget of kWorkFactor * n, and once the next pass does not fit, the range
+ *   is finished by the deterministic median-of-medians selection. Sampling
+ *   recursions get budgets of their own size, so the worst case is O(n).
+ *   Indices are signed and inclusive, index is 0-based in the whole array.
+ */
+
+const int64_t kGroupSize = 5;
+const int64_t kSamplingSize = 600;
+const int64_t kWorkFactor = 6;
+
+template <typename T>
+void InsertionSort(std::vector<T>& array, int64_t left, int64_t right) {
+  for (int64_t i = left + 1; i <= right; ++i) {
+    T current = array[i];
+    int64_t j = i;
+    for (; j > left && current < array[j - 1]; --j) {
+      array[j] = array[j - 1];
+    }
+    array[j] = current;
+  }
+}
+
+// After it [left, first) < pivot, [first, second) == pivot and
+// [second, right] > pivot.
+template <typename T>
+std::pair<int64_t, int64_t> ThreeWayPartition(std::vector<T>& array,
+                                              int64_t left, int64_t right,
+                                              const T& pivot) {
+  int64_t less_end = left;
+  int64_t current = left;
+  int64_t greater_begin = right + 1;
+
+  while (current < greater_begin) {
+    if (array[current] < pivot) {
+      std::swap(array[less_end++], array[current++]);
+    } else if (pivot < array[current]) {
+      std::swap(array[current], array[--greater_begin]);
+    } else {
+      ++current;
+    }
+  }
+
+  return std::pair(less_end, greater_begin);
+}
+
+template <typename T>
+T MedianOfMediansSelect(std::vector<T>& array, int64_t left, int64_t right,
+                        int64_t index) {
+  while (right - left >= kGroupSize) {
+    int64_t groups_number = (right - left + 1) / kGroupSize;
+    for (int64_t i = 0; i < groups_number; ++i) {
+      int64_t group_left = left + kGroupSize * i;
+      InsertionSort(array, group_left, group_left + kGroupSize - 1);
+      std::swap(array[left + i], array[group_left + kGroupSize / 2]);
+    }
+
+    T pivot = MedianOfMediansSelect(array, left, left + groups_number - 1,
+                                    left + groups_number / 2);
+    auto [less_end, greater_begin] =
+        ThreeWayPartition(array, left, right, pivot);
+
+    if (index < less_end) {
+      right = less_end - 1;
+    } else if (index < greater_begin) {
+      return pivot;
+    } else {
+      left = greater_begin;
+    }
+  }
+
+  InsertionSort(array, left, right);
+  return array[index];
+}
+
+// Elements a selection over size elements may partition before falling back.
+int64_t WorkBudget(int64_t size) {
+  return kWorkFactor * size;
+}
+
+template <typename T>
+T FloydRivestSelect(std::vector<T>& array, int64_t left, int64_t right,
+                    int64_t index, int64_t work_allowed) {
+  while (right > left) {
+    int64_t old_size = right - left + 1;
+    if (work_allowed < old_size) {
+      return MedianOfMediansSelect(array, left, right, index);
+    }
+    work_allowed -= old_size;
+
+    if (old_size > kSamplingSize) {
+      double size = static_cast<double>(old_size);
+      double position = static_cast<double>(index - left + 1);
+      double log_size = std::log(size);
+      double sample_size = 0.5 * std::exp(2 * log_size / 3);
+      double deviation =
+          0.5 * std::sqrt(log_size * sample_size * (size - sample_size) / size);
+      if (position < size / 2) {
+        deviation = -deviation;
+      }
+
+      int64_t sample_left = std::max(
+          left, static_cast<int64_t>(index - position * sample_size / size +
+                                     deviation));
+      int64_t sample_right = std::min(
+          right,
+          static_cast<int64_t>(index + (size - position) * sample_size / size +
+                               deviation));
+      FloydRivestSelect(array, sample_left, sample_right, index,
+                        WorkBudget(sample_right - sample_left + 1));
+    }
+
+    T pivot = array[index];
+    int64_t i = left;
+    int64_t j = right;
+
+    std::swap(array[left], array[index]);
+    if (pivot < array[right]) {
+      std::swap(array[right], array[left]);
+    }
+    while (i < j) {
+      std::swap(array[i], array[j]);
+      ++i;
+      --j;
+      while (array[i] < pivot) {
+        ++i;
+      }
+      while (pivot < array[j]) {
+        --j;
+      }
+    }
+
+    if (!(array[left] < pivot) && !(pivot < array[left])) {
+      std::swap(array[left], array[j]);
+    } else {
+      ++j;
+      std::swap(array[j], array[right]);
+    }
+
+    if (j <= index) {
+      left = j + 1;
+    }
+    if (index <= j) {
+      right = j - 1;
+    }
+  }
+
+  return array[index];
+}
+
+// Same contract as KthStat: kth_stat counts from 1.
+template <typename T>
+T FloydRivestKthStat(std::vector<T>& array, size_t kth_stat) {
+  int64_t size = static_cast<int64_t>(array.size());
+  return FloydRivestSelect(array, 0, size - 1,
+                           static_cast<int64_t>(kth_stat) - 1,
+                           WorkBudget(size));
+}
+
+/*  Multi-selection: the middle requested rank is selected first, after that
+ *   the range is partitioned around it, and only the sides that still hold
+ *   requested ranks are processed. m ranks cost O(n log m) in total instead
+ *   of m full selections.
+ */
+
+template <typename T>
+void MultiSelect(std::vector<T>& array, int64_t left, int64_t right,
+                 const std::vector<int64_t>& indices, size_t first,
+                 size_t last, std::vector<T>& result) {
+  if (first == last) {
+    return;
+  }
+
+  size_t middle = first + (last - first) / 2;
+  result[middle] = FloydRivestSelect(array, left, right, indices[middle],
+                                     WorkBudget(right - left + 1));
+
+  size_t left_last = middle;
+  while (left_last > first && indices[left_last - 1] == indices[middle]) {
+    result[--left_last] = result[middle];
+  }
+  size_t right_first = middle + 1;
+  while (right_first < last && indices[right_first] == indices[middle]) {
+    result[right_first++] = result[middle];
+  }
+
+  MultiSelect(array, left, indices[middle] - 1, indices, first, left_last,
+              result);
+  MultiSelect(array, indices[middle] + 1, right, indices, right_first, last,
+              result);
+}
+
+// kth_stats count from 1 like in KthStat, answers follow their order.
+template <typename T>
+std::vector<T> KthStats(std::vector<T>& array,
+                        const std::vector<size_t>& kth_stats) {
+  std::vector<size_t> order(kth_stats.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&kth_stats](size_t lhs, size_t rhs) {
+    return kth_stats[lhs] < kth_stats[rhs];
+  });
+
+  std::vector<int64_t> indices(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    indices[i] = static_cast<int64_t>(kth_stats[order[i]]) - 1;
+  }
+
+  std::vector<T> sorted_result(order.size());
+  MultiSelect(array, 0, static_cast<int64_t>(array.size()) - 1, indices, 0,
+              indices.size(), sorted_result);
+
+  std::vector<T> result(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    result[order[i]] = sorted_result[i];
+  }
+
+  return result;
+}
+
+/*         KllSketch
+*  Streaming mergeable quantile sketch (Karnin–Lang–Liberty). Level h keeps
+*  items of weight 2^h, capacities shrink by 2/3 from the top level down to
+*  at least 2 items. A full level is sorted and every other item (random
+*  offset) is promoted to the next level. Memory is O(k) items.
+*  Error: with probability 99% the rank of Quantile(q) differs from q * n by
+*  at most RankError() * n = 3.3 * n / k (1.65% for k = 200), independently
+*  of n and of the order of Insert and Merge calls, so sketches built on
+*  shards in parallel merge into one with the same guarantee. The bound
+*  needs independent promotion coins: by default every sketch is seeded
+*  from std::random_device, explicit seeds must differ between shards.
+*  Usage:
+*   Creation:
+*    KllSketch<T> sketch(k);
+*    KllSketch<T> sketch(k, seed);  // reproducible
+*   Operations:
+*    sketch.Insert(value)
+*    sketch.Merge(other)
+*    sketch.Quantile(q)  // q in [0, 1]
+*    sketch.Size()
+*/
+
+template <typename T>
+class KllSketch {
+ public:
+  explicit KllSketch(size_t k = kDefaultK,
+                     uint64_t seed = std::random_device{}())
+      : k_(std::max(k, kMinK)), generator_(seed) {}
+
+  void Insert(const T& value) {
+    levels_[0].push_back(value);
+    ++size_;
+    ++stored_items_;
+    Compress();
+  }
+
+  void Merge(const KllSketch& other) {
+    if (other.levels_.size() > levels_.size()) {
+      levels_.resize(other.levels_.size());
+      UpdateCapacities();
+    }
+    for (size_t level = 0; level < other.levels_.size(); ++level) {
+      levels_[level].insert(levels_[level].end(),
+                            other.levels_[level].begin(),
+                            other.levels_[level].end());
+    }
+    size_ += other.size_;
+    stored_items_ += other.stored_items_;
+    Compress();
+  }
 
+  T Quantile(double quantile) const {
+    std::vector<std::pair<T, uint64_t>> weighted = WeightedItems();
+    double target = quantile * static_cast<double>(size_);
+
+    uint64_t cumulative_weight = 0;
+    for (const auto& [value, weight] : weighted) {
+      cumulative_weight += weight;
+      if (static_cast<double>(cumulative_weight) >= target) {
+        return value;
+      }
+    }
+    return weighted.back().first;
+  }
+
+  size_t Size() const { return size_; }
+
+  // Normalized rank error guaranteed with probability 99% (empirical
+  // constant of the KLL analysis).
+  double RankError() const { return kRankErrorFactor / k_; }
+
+ private:
+  static constexpr size_t kDefaultK = 200;
+  static constexpr size_t kMinK = 8;
+  static constexpr size_t kMinCapacity = 2;
+  static constexpr double kCapacityRatio = 2.0 / 3.0;
+  static constexpr double kRankErrorFactor = 3.3;
+
+  size_t k_;
+  size_t size_ = 0;
+  size_t stored_items_ = 0;
+  std::vector<std::vector<T>> levels_ = std::vector<std::vector<T>>(1);
+  std::vector<size_t> capacities_ = std::vector<size_t>(1, k_);
+  size_t total_capacity_ = k_;
+  std::mt19937_64 generator_;
+
+  void UpdateCapacities() {
+    capacities_.resize(levels_.size());
+    total_capacity_ = 0;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+      double depth = static_cast<double>(levels_.size() - 1 - level);
+      capacities_[level] = std::max(
+          kMinCapacity, static_cast<size_t>(std::ceil(
+                            static_cast<double>(k_) *
+                            std::pow(kCapacityRatio, depth))));
+      total_capacity_ += capacities_[level];
+    }
+  }
+
+  void Compress() {
+    while (stored_items_ >= total_capacity_) {
+      size_t level = 0;
+      while (levels_[level].size() < capacities_[level]) {
+        ++level;
+      }
+      if (level + 1 == levels_.size()) {
+        levels_.emplace_back();
+        UpdateCapacities();
+      }
+
+      std::vector<T>& current = levels_[level];
+      std::sort(current.begin(), current.end());
+
+      // An odd item stays on its level to keep the total weight exact.
+      size_t kept = current.size() % 2;
+      size_t offset = kept + generator_() % 2;
+      size_t promoted = 0;
+      for (size_t i = offset; i < current.size(); i += 2) {
+        levels_[level + 1].push_back(current[i]);
+        ++promoted;
+      }
+      stored_items_ -= current.size() - kept - promoted;
+      current.resize(kept);
+    }
+  }
+
+  std::vector<std::pair<T, uint64_t>> WeightedItems() const {
+    std::vector<std::pair<T, uint64_t>> weighted;
+    weighted.reserve(stored_items_);
+    for (size_t level = 0; level < levels_.size(); ++level) {
+      for (const auto& value : levels_[level]) {
+        weighted.emplace_back(value, uint64_t(1) << level);
+      }
+    }
+    std::sort(weighted.begin(), weighted.end());
+    return weighted;
+  }
+};
+
+/*  Exact refinement for data that can be streamed twice: the sketch gives
+ *   values that bracket the requested rank with the guaranteed error, the
+ *   second pass counts elements below the lower bracket and keeps only the
+ *   ones between the brackets (about 2 * RankError() * n of them), and the
+ *   exact answer is selected among them. for_each(visitor) must call visitor
+ *   for every element of the stream. Returns false if the rank falls outside
+ *   the brackets, which happens with probability below 1%.
+ */
+
+template <typename T, typename ForEach>
+bool RefineKthStat(const KllSketch<T>& sketch, size_t kth_stat,
+                   ForEach for_each, T& result) {
+  double size = static_cast<double>(sketch.Size());
+  double quantile = static_cast<double>(kth_stat) / size;
+  double lower_quantile = quantile - sketch.RankError();
+  double upper_quantile = quantile + sketch.RankError();
+
+  // Near the ends the bracket is open: the sketch may miss the extremes.
+  bool has_lower = lower_quantile > 0;
+  bool has_upper = upper_quantile < 1;
+  T lower = sketch.Quantile(std::max(0.0, lower_quantile));
+  T upper = sketch.Quantile(std::min(1.0, upper_quantile));
+
+  size_t below = 0;
+  std::vector<T> candidates;
+  for_each([&](const T& value) {
+    if (has_lower && value < lower) {
+      ++below;
+    } else if (!has_upper || !(upper < value)) {
+      candidates.push_back(value);
+    }
+  });
+
+  if (kth_stat <= below || kth_stat > below + candidates.size()) {
+    return false;
+  }
+
+  result = FloydRivestKthStat(candidates, kth_stat - below);
+  return true;
+}
+
+/*  Input generation: a[i] = (kXcoef * a[i - 1] + kYcoef * a[i - 2]) % kMod,
+ *   i.e. (a[i + 1], a[i]) = M^i * (a[1], a[0]) with M = {{kXcoef, kYcoef},
+ *   {1, 0}} modulo kMod. M^i gives the state at any offset in O(log i), so
+ *   every thread fills its own chunk independently.
+ */
+
+namespace Recurrence {
+const int64_t kXcoef = 123;
+const int64_t kYcoef = 45;
+const int64_t kMod = 10004321;
+
+using Matrix = std::array<std::array<int64_t, 2>, 2>;
+using State = std::pair<int64_t, int64_t>;  // (a[i], a[i + 1])
+
+Matrix Multiply(const Matrix& lhs, const Matrix& rhs) {
+  Matrix result{};
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 2; ++j) {
+      result[i][j] = (lhs[i][0] * rhs[0][j] + lhs[i][1] * rhs[1][j]) % kMod;
+    }
+  }
+  return result;
+}
+
+Matrix Power(size_t exponent) {
+  Matrix result = {{{1, 0}, {0, 1}}};
+  Matrix base = {{{kXcoef, kYcoef}, {1, 0}}};
+
+  for (; exponent > 0; exponent /= 2) {
+    if (exponent % 2 == 1) {
+      result = Multiply(result, base);
+    }
+    base = Multiply(base, base);
+  }
+  return result;
+}
+
+State Advance(const Matrix& jump, const State& state) {
+  return State((jump[1][0] * state.second + jump[1][1] * state.first) % kMod,
+               (jump[0][0] * state.second + jump[0][1] * state.first) % kMod);
+}
+
+State StateAt(int64_t a_0, int64_t a_1, size_t offset) {
+  return Advance(Power(offset), State(a_0, a_1));
+}
+
+// Calls visitor(a[i]) for i in [begin, end).
+template <typename Visitor>
+void Generate(int64_t a_0, int64_t a_1, size_t begin, size_t end,
+              Visitor visitor) {
+  auto [current, next] = StateAt(a_0, a_1, begin);
+  for (size_t i = begin; i < end; ++i) {
+    visitor(static_cast<int32_t>(current));
+    int64_t following = (kXcoef * next + kYcoef * current) % kMod;
+    current = next;
+    next = following;
+  }
+}
+
+// Runs chunk_function(thread, begin, end) on threads_number threads.
+template <typename ChunkFunction>
+void ForEachChunk(size_t size, size_t threads_number,
+                  ChunkFunction chunk_function) {
+  threads_number = std::max<size_t>(1, threads_number);
+  size_t chunk_size = (size + threads_number - 1) / threads_number;
+
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < threads_number; ++thread) {
+    size_t begin = std::min(thread * chunk_size, size);
+    size_t end = std::min(begin + chunk_size, size);
+    threads.emplace_back(chunk_function, thread, begin, end);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+}  // namespace Recurrence
+
+std::vector<int32_t> GenerateArray(size_t array_size, int32_t a_0,
+                                   int32_t a_1, size_t threads_number) {
+  std::vector<int32_t> array(array_size);
+  Recurrence::ForEachChunk(
+      array_size, threads_number, [&](size_t, size_t begin, size_t end) {
+        int32_t* output = array.data() + begin;
+        Recurrence::Generate(a_0, a_1, begin, end,
+                             [&output](int32_t value) { *output++ = value; });
+      });
+  return array;
+}
+
+/*  Fused mode: the array is never stored. A strided sample (one jump matrix
+ *   per step) gives two values that bracket the k-th element like in
+ *   FloydRivestSelect, then one parallel generation pass counts the elements
+ *   below the bracket and keeps only the ones inside it, and the answer is
+ *   selected among them. If the bracket misses (unlikely), the array is
+ *   generated and selected as usual.
+ */
+
+int32_t FusedKthStat(size_t array_size, size_t kth_stat, int32_t a_0,
+                     int32_t a_1, size_t threads_number) {
+  const size_t kMinFusedSize = 1 << 16;
+
+  if (array_size < kMinFusedSize) {
+    std::vector<int32_t> array = GenerateArray(array_size, a_0, a_1, 1);
+    return FloydRivestKthStat(array, kth_stat);
+  }
+
+  double size = static_cast<double>(array_size);
+  auto sample_size = static_cast<size_t>(std::exp(2 * std::log(size) / 3));
+  size_t stride = array_size / sample_size;
+
+  std::vector<int32_t> sample(sample_size);
+  Recurrence::Matrix jump = Recurrence::Power(stride);
+  Recurrence::State state(a_0, a_1);
+  for (size_t i = 0; i < sample_size; ++i) {
+    sample[i] = static_cast<int32_t>(state.first);
+    state = Recurrence::Advance(jump, state);
+  }
+
+  auto sample_rank = static_cast<double>(kth_stat) * sample_size / size;
+  double deviation = std::sqrt(std::log(size) * sample_size);
+  auto lower_rank = static_cast<int64_t>(sample_rank - deviation);
+  auto upper_rank = static_cast<int64_t>(sample_rank + deviation);
+  bool has_lower = lower_rank >= 1;
+  bool has_upper = upper_rank <= static_cast<int64_t>(sample_size);
+  int32_t lower = has_lower ? FloydRivestKthStat(sample, lower_rank) : 0;
+  int32_t upper = has_upper ? FloydRivestKthStat(sample, upper_rank) : 0;
+
+  threads_number = std::max<size_t>(1, threads_number);
+  std::vector<size_t> below(threads_number);
+  std::vector<std::vector<int32_t>> candidates(threads_number);
+  Recurrence::ForEachChunk(
+      array_size, threads_number,
+      [&](size_t thread, size_t begin, size_t end) {
+        size_t thread_below = 0;
+        std::vector<int32_t>& thread_candidates = candidates[thread];
+        Recurrence::Generate(a_0, a_1, begin, end, [&](int32_t value) {
+          if (has_lower && value < lower) {
+            ++thread_below;
+          } else if (!has_upper || value <= upper) {
+            thread_candidates.push_back(value);
+          }
+        });
+        below[thread] = thread_below;
+      });
+
+  size_t total_below = 0;
+  std::vector<int32_t> all_candidates;
+  for (size_t thread = 0; thread < threads_number; ++thread) {
+    total_below += below[thread];
+    all_candidates.insert(all_candidates.end(), candidates[thread].begin(),
+                          candidates[thread].end());
+  }
+
+  if (kth_stat <= total_below ||
+      kth_stat > total_below + all_candidates.size()) {
+    std::vector<int32_t> array =
+        GenerateArray(array_size, a_0, a_1, threads_number);
+    return FloydRivestKthStat(array, kth_stat);
+  }
+  return FloydRivestKthStat(all_candidates, kth_stat - total_below);
+}
+
+int main() {
   size_t array_size;
   size_t kth_stat;
   int32_t a_0;
@@ -55,15 +626,8 @@ int main() {
 
   std::cin >> array_size >> kth_stat >> a_0 >> a_1;
 
-  std::vector<int32_t> array(array_size);
-  array[0] = a_0;
-  array[1] = a_1;
-
-  for (size_t i = 2; i < array_size; ++i) {
-    array[i] = (array[i - 1] * kXcoef + array[i - 2] * kYcoef) % kMod;
-  }
-
-  std::cout << KthStat(array, 0, array.size() - 1, kth_stat);
+  std::cout << FusedKthStat(array_size, kth_stat, a_0, a_1,
+                            std::thread::hardware_concurrency());
 
   return 0;
 }
@@ -1,35 +1,649 @@
-#include <cmath>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Sizes {
-const auto kBucketsSize = static_cast<size_t>(pow(2, 8));
+const size_t kDigitBits = 8;
+const size_t kBucketsSize = size_t{1} << kDigitBits;
+const uint64_t kDigitMask = kBucketsSize - 1;
 const size_t kMaxSteps = sizeof(uint64_t);
+const size_t kInsertionSortSize = 32;
 }  // namespace Sizes
 
-std::vector<uint64_t> LsdSort(std::vector<uint64_t>& numbers, size_t step = 0) {
-  if (step == Sizes::kMaxSteps) {
-    return numbers;
+using Buckets = std::array<size_t, Sizes::kBucketsSize>;
+using Histograms = std::array<Buckets, Sizes::kMaxSteps>;
+
+size_t Digit(uint64_t number, size_t step) {
+  return (number >> (step * Sizes::kDigitBits)) & Sizes::kDigitMask;
+}
+
+// Counts digits of every step in a single read of the array.
+template <typename Item, typename RadixKey>
+Histograms CountDigits(const std::vector<Item>& items, RadixKey radix_key) {
+  Histograms histograms{};
+  for (const auto& item : items) {
+    uint64_t key = radix_key(item);
+    for (size_t step = 0; step < Sizes::kMaxSteps; ++step) {
+      ++histograms[step][Digit(key, step)];
+    }
+  }
+  return histograms;
+}
+
+// A step is trivial when every number has the same digit on it: the pass
+// would only copy the array.
+bool IsTrivialStep(const Buckets& buckets, size_t size) {
+  for (const auto& count : buckets) {
+    if (count != 0) {
+      return count == size;
+    }
+  }
+  return true;
+}
+
+// Turns counts into exclusive prefix sums: the first position of each bucket.
+void ToOffsets(Buckets& buckets) {
+  size_t offset = 0;
+  for (auto& count : buckets) {
+    size_t bucket_size = count;
+    count = offset;
+    offset += bucket_size;
+  }
+}
+
+// Stable: items with equal keys keep their order.
+template <typename Item, typename RadixKey>
+void LsdSort(std::vector<Item>& items, RadixKey radix_key) {
+  Histograms histograms = CountDigits(items, radix_key);
+  std::vector<Item> buffer;
+
+  for (size_t step = 0; step < Sizes::kMaxSteps; ++step) {
+    Buckets& offsets = histograms[step];
+    if (IsTrivialStep(offsets, items.size())) {
+      continue;
+    }
+    if (buffer.empty()) {
+      buffer.resize(items.size());
+    }
+    ToOffsets(offsets);
+    for (const auto& item : items) {
+      buffer[offsets[Digit(radix_key(item), step)]++] = item;
+    }
+    items.swap(buffer);
+  }
+}
+
+void LsdSort(std::vector<uint64_t>& numbers) {
+  LsdSort(numbers, [](uint64_t number) { return number; });
+}
+
+void InsertionSort(uint64_t* begin, uint64_t* end) {
+  for (uint64_t* current = begin; current != end; ++current) {
+    uint64_t number = *current;
+    uint64_t* place = current;
+    for (; place != begin && *(place - 1) > number; --place) {
+      *place = *(place - 1);
+    }
+    *place = number;
+  }
+}
+
+// American flag sort: numbers are permuted into buckets of the digit on
+// the given step by following swap cycles, then every bucket is sorted by
+// the lower digits. Extra memory is two bucket arrays per recursion level.
+void MsdSort(uint64_t* begin, uint64_t* end, size_t step) {
+  while (static_cast<size_t>(end - begin) > Sizes::kInsertionSortSize) {
+    Buckets heads{};
+    for (const uint64_t* number = begin; number != end; ++number) {
+      ++heads[Digit(*number, step)];
+    }
+    bool trivial = IsTrivialStep(heads, end - begin);
+    if (trivial && step == 0) {
+      return;
+    }
+    if (trivial) {
+      --step;
+      continue;
+    }
+
+    ToOffsets(heads);
+    Buckets tails;
+    for (size_t digit = 0; digit + 1 < Sizes::kBucketsSize; ++digit) {
+      tails[digit] = heads[digit + 1];
+    }
+    tails.back() = end - begin;
+
+    for (size_t bucket = 0; bucket < Sizes::kBucketsSize; ++bucket) {
+      while (heads[bucket] < tails[bucket]) {
+        uint64_t number = begin[heads[bucket]];
+        for (size_t digit = Digit(number, step); digit != bucket;
+             digit = Digit(number, step)) {
+          std::swap(number, begin[heads[digit]++]);
+        }
+        begin[heads[bucket]++] = number;
+      }
+    }
+    if (step == 0) {
+      return;
+    }
+    // Heads now point at bucket ends.
+    uint64_t* bucket_begin = begin;
+    for (size_t bucket = 0; bucket < Sizes::kBucketsSize; ++bucket) {
+      MsdSort(bucket_begin, begin + heads[bucket], step - 1);
+      bucket_begin = begin + heads[bucket];
+    }
+    return;
+  }
+  InsertionSort(begin, end);
+}
+
+void MsdSort(std::vector<uint64_t>& numbers) {
+  MsdSort(numbers.data(), numbers.data() + numbers.size(),
+          Sizes::kMaxSteps - 1);
+}
+
+namespace Parallel {
+// Numbers per write-combining buffer: one 64-byte cache line.
+const size_t kCombineSize = 8;
+const size_t kMinChunkSize = size_t{1} << 16;
+}  // namespace Parallel
+
+template <typename Function>
+void RunInParallel(size_t threads, Function function) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (size_t thread = 1; thread < threads; ++thread) {
+    workers.emplace_back(function, thread);
+  }
+  function(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+size_t ChunkBegin(size_t size, size_t threads, size_t thread) {
+  return size / threads * thread + std::min(size % threads, thread);
+}
+
+// Scatter stores go to a cache-resident line per bucket and reach the
+// output one full line at a time.
+struct alignas(64) CombineBuffer {
+  std::array<uint64_t, Parallel::kCombineSize> items;
+};
+
+// The first flush of a bucket only fills its output up to the next cache
+// line boundary, so every later flush writes one whole aligned line.
+void ScatterChunk(const uint64_t* begin, const uint64_t* end, size_t step,
+                  Buckets& offsets, uint64_t* output) {
+  std::vector<CombineBuffer> combine(Sizes::kBucketsSize);
+  Buckets filled{};
+  Buckets limits;
+  for (size_t digit = 0; digit < Sizes::kBucketsSize; ++digit) {
+    auto address = reinterpret_cast<uintptr_t>(output + offsets[digit]);
+    limits[digit] = Parallel::kCombineSize -
+                    address / sizeof(uint64_t) % Parallel::kCombineSize;
+  }
+
+  for (const uint64_t* number = begin; number != end; ++number) {
+    size_t digit = Digit(*number, step);
+    combine[digit].items[filled[digit]++] = *number;
+    if (filled[digit] == limits[digit]) {
+      std::copy(combine[digit].items.begin(),
+                combine[digit].items.begin() + filled[digit],
+                output + offsets[digit]);
+      offsets[digit] += filled[digit];
+      filled[digit] = 0;
+      limits[digit] = Parallel::kCombineSize;
+    }
+  }
+  for (size_t digit = 0; digit < Sizes::kBucketsSize; ++digit) {
+    std::copy(combine[digit].items.begin(),
+              combine[digit].items.begin() + filled[digit],
+              output + offsets[digit]);
+  }
+}
+
+// Every thread owns a contiguous chunk. Bucket b of thread t starts after
+// buckets below b of all threads and bucket b of threads below t, which
+// keeps each pass stable.
+void ParallelLsdSort(std::vector<uint64_t>& numbers, size_t threads) {
+  threads = std::min(threads, numbers.size() / Parallel::kMinChunkSize);
+  if (threads <= 1) {
+    LsdSort(numbers);
+    return;
+  }
+
+  std::vector<Histograms> local(threads);
+  RunInParallel(threads, [&](size_t thread) {
+    for (size_t i = ChunkBegin(numbers.size(), threads, thread);
+         i < ChunkBegin(numbers.size(), threads, thread + 1); ++i) {
+      for (size_t step = 0; step < Sizes::kMaxSteps; ++step) {
+        ++local[thread][step][Digit(numbers[i], step)];
+      }
+    }
+  });
+  Histograms histograms{};
+  for (const auto& histogram : local) {
+    for (size_t step = 0; step < Sizes::kMaxSteps; ++step) {
+      for (size_t digit = 0; digit < Sizes::kBucketsSize; ++digit) {
+        histograms[step][digit] += histogram[step][digit];
+      }
+    }
+  }
+
+  std::vector<uint64_t> buffer;
+  std::vector<Buckets> offsets(threads);
+  bool first_pass = true;
+  for (size_t step = 0; step < Sizes::kMaxSteps; ++step) {
+    if (IsTrivialStep(histograms[step], numbers.size())) {
+      continue;
+    }
+    if (buffer.empty()) {
+      buffer.resize(numbers.size());
+    }
+    // Chunks keep their counts only until the first scatter moves numbers.
+    RunInParallel(threads, [&](size_t thread) {
+      if (first_pass) {
+        offsets[thread] = local[thread][step];
+        return;
+      }
+      offsets[thread].fill(0);
+      for (size_t i = ChunkBegin(numbers.size(), threads, thread);
+           i < ChunkBegin(numbers.size(), threads, thread + 1); ++i) {
+        ++offsets[thread][Digit(numbers[i], step)];
+      }
+    });
+    first_pass = false;
+
+    size_t offset = 0;
+    for (size_t digit = 0; digit < Sizes::kBucketsSize; ++digit) {
+      for (size_t thread = 0; thread < threads; ++thread) {
+        size_t count = offsets[thread][digit];
+        offsets[thread][digit] = offset;
+        offset += count;
+      }
+    }
+
+    RunInParallel(threads, [&](size_t thread) {
+      ScatterChunk(numbers.data() + ChunkBegin(numbers.size(), threads, thread),
+                   numbers.data() +
+                       ChunkBegin(numbers.size(), threads, thread + 1),
+                   step, offsets[thread], buffer.data());
+    });
+    numbers.swap(buffer);
+  }
+}
+
+// Radix keys: unsigned images of keys that preserve their order.
+template <typename Key>
+std::enable_if_t<std::is_unsigned_v<Key>, uint64_t> ToRadixKey(Key key) {
+  return key;
+}
+
+// Flipping the sign bit moves negative numbers below non-negative ones.
+template <typename Key>
+std::enable_if_t<std::is_signed_v<Key> && std::is_integral_v<Key>, uint64_t>
+ToRadixKey(Key key) {
+  const uint64_t sign_bit = uint64_t{1} << 63;
+  return static_cast<uint64_t>(static_cast<int64_t>(key)) ^ sign_bit;
+}
+
+// IEEE 754: non-negative numbers are ordered as their bits with the sign
+// set, negative numbers are ordered as their inverted bits. -0.0 goes
+// before 0.0, NaNs go to the ends according to their sign.
+template <typename Key>
+std::enable_if_t<std::is_floating_point_v<Key>, uint64_t> ToRadixKey(
+    Key key) {
+  const uint64_t sign_bit = uint64_t{1} << 63;
+  double value = key;
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & sign_bit) != 0 ? ~bits : bits | sign_bit;
+}
+
+// Moves records[order[i]] to position i by following permutation cycles;
+// every record is moved once and order is consumed.
+template <typename Record>
+void ApplyPermutation(std::vector<Record>& records,
+                      std::vector<size_t>& order) {
+  for (size_t start = 0; start < records.size(); ++start) {
+    if (order[start] == start) {
+      continue;
+    }
+    Record record = std::move(records[start]);
+    size_t position = start;
+    while (order[position] != start) {
+      size_t source = order[position];
+      records[position] = std::move(records[source]);
+      order[position] = position;
+      position = source;
+    }
+    records[position] = std::move(record);
+    order[position] = position;
+  }
+}
+
+struct KeyedIndex {
+  uint64_t key;
+  size_t index;
+};
+
+// Stable radix sort of records by key(record), which returns any integral or
+// floating-point key. Only keys and indices pass through the radix passes;
+// records are moved once, at the end.
+template <typename Record, typename KeyExtractor>
+void RadixSortBy(std::vector<Record>& records, KeyExtractor key) {
+  std::vector<KeyedIndex> keyed(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    keyed[i] = {ToRadixKey(key(records[i])), i};
+  }
+  LsdSort(keyed, [](const KeyedIndex& item) { return item.key; });
+
+  std::vector<size_t> order(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    order[i] = keyed[i].index;
+  }
+  ApplyPermutation(records, order);
+}
+
+namespace External {
+// Numbers sorted in memory at once: 1 GiB.
+const size_t kChunkSize = size_t{1} << 27;
+// Smallest read buffer of a run during the merge: 512 KiB.
+const size_t kMinBufferSize = size_t{1} << 16;
+// Largest one: 8 MiB blocks already make I/O sequential.
+const size_t kMaxBufferSize = size_t{1} << 20;
+// Runs merged at once, which also bounds the open temporary files per merge
+// level well below the usual limit of 1024 descriptors.
+const size_t kMaxMergeFanIn = 128;
+}  // namespace External
+
+using File = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+File OpenFile(const std::string& path, const char* mode) {
+  File file(std::fopen(path.c_str(), mode), &std::fclose);
+  if (!file) {
+    throw std::runtime_error("cannot open " + path);
+  }
+  return file;
+}
+
+// TMPDIR if it is set, otherwise the directory of the output file: runs
+// take as much space as the input, which a RAM-backed /tmp may not have.
+std::string DefaultSpillDirectory(const std::string& output_path) {
+  const char* temporary_directory = std::getenv("TMPDIR");
+  if (temporary_directory != nullptr && *temporary_directory != '\0') {
+    return temporary_directory;
+  }
+  size_t separator = output_path.rfind('/');
+  if (separator == std::string::npos) {
+    return ".";
+  }
+  return separator == 0 ? "/" : output_path.substr(0, separator);
+}
+
+// The file is unlinked right after creation, so it disappears when closed
+// even if the sort fails.
+File CreateTemporaryFile(const std::string& directory) {
+  std::string path = directory + "/external-sort-run-XXXXXX";
+  int file_descriptor = mkstemp(path.data());
+  if (file_descriptor < 0) {
+    throw std::runtime_error("cannot create a temporary file in " +
+                             directory);
+  }
+  unlink(path.c_str());
+  File file(fdopen(file_descriptor, "w+b"), &std::fclose);
+  if (!file) {
+    close(file_descriptor);
+    throw std::runtime_error("cannot open a temporary file in " + directory);
+  }
+  return file;
+}
+
+// Reads bytes rather than whole numbers, so a file whose size is not a
+// multiple of sizeof(uint64_t) is reported instead of silently truncated.
+size_t ReadBlock(std::FILE* file, uint64_t* data, size_t count) {
+  size_t read = std::fread(data, 1, count * sizeof(uint64_t), file);
+  if (read < count * sizeof(uint64_t) && std::ferror(file) != 0) {
+    throw std::runtime_error("read failed");
+  }
+  if (read % sizeof(uint64_t) != 0) {
+    throw std::runtime_error("partial trailing record");
+  }
+  return read / sizeof(uint64_t);
+}
+
+void WriteBlock(std::FILE* file, const uint64_t* data, size_t count) {
+  if (std::fwrite(data, sizeof(uint64_t), count, file) != count) {
+    throw std::runtime_error("write failed");
+  }
+}
+
+// Leaves elements created by resize uninitialized instead of zeroing them:
+// chunks and run buffers are overwritten anyway, and untouched pages of a
+// large buffer are never faulted in.
+template <typename T>
+class DefaultInitAllocator : public std::allocator<T> {
+ public:
+  template <typename U>
+  struct rebind {
+    using other = DefaultInitAllocator<U>;
+  };
+
+  using std::allocator<T>::allocator;
+
+  template <typename U>
+  void construct(U* place) {
+    ::new (static_cast<void*>(place)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* place, Args&&... args) {
+    ::new (static_cast<void*>(place)) U(std::forward<Args>(args)...);
+  }
+};
+
+using Chunk = std::vector<uint64_t, DefaultInitAllocator<uint64_t>>;
+
+class RunReader {
+ public:
+  RunReader(File file, size_t buffer_size)
+      : file_(std::move(file)), buffer_(buffer_size) {
+    Refill();
+  }
+
+  bool Empty() const {
+    return position_ == filled_;
   }
-  std::vector<int32_t> buckets(Sizes::kBucketsSize);
-  std::vector<uint64_t> result(numbers.size());
 
-  int64_t decreaser = static_cast<int64_t>(pow(Sizes::kBucketsSize, step));
+  uint64_t Front() const {
+    return buffer_[position_];
+  }
+
+  void Pop() {
+    if (++position_ == filled_) {
+      Refill();
+    }
+  }
+
+ private:
+  void Refill() {
+    filled_ = ReadBlock(file_.get(), buffer_.data(), buffer_.size());
+    position_ = 0;
+  }
+
+  File file_;
+  Chunk buffer_;
+  size_t position_ = 0;
+  size_t filled_ = 0;
+};
+
+class BufferedWriter {
+ public:
+  BufferedWriter(std::FILE* file, size_t buffer_size) : file_(file) {
+    buffer_.reserve(buffer_size);
+  }
+
+  void Write(uint64_t number) {
+    buffer_.push_back(number);
+    if (buffer_.size() == buffer_.capacity()) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    WriteBlock(file_, buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+
+ private:
+  std::FILE* file_;
+  std::vector<uint64_t> buffer_;
+};
+
+// K-way merge through a heap of run heads. Every run and the output get
+// buffer_size numbers of memory.
+void MergeRuns(std::vector<File> runs, std::FILE* output,
+               size_t buffer_size) {
+  std::vector<RunReader> readers;
+  readers.reserve(runs.size());
+  for (auto& run : runs) {
+    readers.emplace_back(std::move(run), buffer_size);
+  }
+
+  using Head = std::pair<uint64_t, size_t>;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+  for (size_t run = 0; run < readers.size(); ++run) {
+    if (!readers[run].Empty()) {
+      heads.emplace(readers[run].Front(), run);
+    }
+  }
+
+  BufferedWriter writer(output, buffer_size);
+  while (!heads.empty()) {
+    size_t run = heads.top().second;
+    writer.Write(heads.top().first);
+    heads.pop();
+    readers[run].Pop();
+    if (!readers[run].Empty()) {
+      heads.emplace(readers[run].Front(), run);
+    }
+  }
+  writer.Flush();
+}
+
+// Merge buffers share the memory of one chunk.
+size_t MergeBufferSize(size_t chunk_size, size_t runs_number) {
+  return std::clamp(chunk_size / (runs_number + 1), External::kMinBufferSize,
+                    External::kMaxBufferSize);
+}
+
+File MergeToTemporaryFile(std::vector<File> runs, size_t chunk_size,
+                          const std::string& spill_directory) {
+  File merged = CreateTemporaryFile(spill_directory);
+  size_t buffer_size = MergeBufferSize(chunk_size, runs.size());
+  MergeRuns(std::move(runs), merged.get(), buffer_size);
+  if (std::fflush(merged.get()) != 0) {
+    throw std::runtime_error("write failed");
+  }
+  std::rewind(merged.get());
+  return merged;
+}
+
+// Sorts the input chunk by chunk in place and spills every sorted chunk to
+// its own temporary file. Runs are kept in levels: kMaxMergeFanIn runs of
+// one level are merged into one run of the next, so open files stay bounded
+// however large the input is. The chunk memory is released for such merges.
+std::vector<File> SpillSortedRuns(std::FILE* input, size_t chunk_size,
+                                  const std::string& spill_directory) {
+  std::vector<std::vector<File>> levels;
+  Chunk chunk;
+  while (true) {
+    chunk.resize(chunk_size);
+    chunk.resize(ReadBlock(input, chunk.data(), chunk_size));
+    if (chunk.empty()) {
+      break;
+    }
+    MsdSort(chunk.data(), chunk.data() + chunk.size(), Sizes::kMaxSteps - 1);
+    File run = CreateTemporaryFile(spill_directory);
+    WriteBlock(run.get(), chunk.data(), chunk.size());
+    if (std::fflush(run.get()) != 0) {
+      throw std::runtime_error("write failed");
+    }
+    std::rewind(run.get());
 
-  for (size_t i = 0; i < numbers.size(); ++i) {
-    ++buckets[(numbers[i] / decreaser) % Sizes::kBucketsSize];
+    for (size_t level = 0;; ++level) {
+      if (level == levels.size()) {
+        levels.emplace_back();
+      }
+      levels[level].push_back(std::move(run));
+      if (levels[level].size() < External::kMaxMergeFanIn) {
+        break;
+      }
+      Chunk().swap(chunk);
+      run = MergeToTemporaryFile(std::move(levels[level]), chunk_size,
+                                 spill_directory);
+      levels[level].clear();
+    }
   }
 
-  for (size_t i = 1; i < buckets.size(); ++i) {
-    buckets[i] += buckets[i - 1];
+  std::vector<File> runs;
+  for (auto& level : levels) {
+    for (auto& run : level) {
+      runs.push_back(std::move(run));
+    }
   }
+  return runs;
+}
 
-  for (int32_t i = numbers.size() - 1; i >= 0; --i) {
-    result[buckets[(numbers[i] / decreaser) % Sizes::kBucketsSize]-- - 1] =
-        numbers[i];
+// Sorts a binary file of native-endian uint64_t that may not fit in memory.
+// Memory use stays about chunk_size numbers in both phases, at most
+// kMaxMergeFanIn runs are merged at once. Runs go to spill_directory,
+// DefaultSpillDirectory(output_path) when it is empty.
+void ExternalSort(const std::string& input_path,
+                  const std::string& output_path,
+                  size_t chunk_size = External::kChunkSize,
+                  std::string spill_directory = "") {
+  if (spill_directory.empty()) {
+    spill_directory = DefaultSpillDirectory(output_path);
+  }
+  std::vector<File> runs;
+  {
+    File input = OpenFile(input_path, "rb");
+    runs = SpillSortedRuns(input.get(), chunk_size, spill_directory);
+  }
+  // Runs of lower levels come first, so the smallest ones are merged.
+  while (runs.size() > External::kMaxMergeFanIn) {
+    std::vector<File> group(
+        std::make_move_iterator(runs.begin()),
+        std::make_move_iterator(runs.begin() + External::kMaxMergeFanIn));
+    runs.erase(runs.begin(), runs.begin() + External::kMaxMergeFanIn);
+    runs.push_back(
+        MergeToTemporaryFile(std::move(group), chunk_size, spill_directory));
   }
 
-  return LsdSort(result, step + 1);
+  size_t buffer_size = MergeBufferSize(chunk_size, runs.size());
+  File output = OpenFile(output_path, "wb");
+  MergeRuns(std::move(runs), output.get(), buffer_size);
+  if (std::fflush(output.get()) != 0) {
+    throw std::runtime_error("write failed");
+  }
 }
 
 void Read(std::vector<uint64_t>& array) {
@@ -44,12 +658,20 @@ void Print(const std::vector<uint64_t>& array) {
   }
 }
 
-int main() {
+// With two arguments sorts a binary file into another one:
+// main <input> <output>.
+int main(int argc, char** argv) {
+  if (argc == 3) {
+    ExternalSort(argv[1], argv[2]);
+    return 0;
+  }
+
   size_t numbers_amount;
   std::cin >> numbers_amount;
 
   std::vector<uint64_t> numbers(numbers_amount);
 
   Read(numbers);
-  Print(LsdSort(numbers));
+  ParallelLsdSort(numbers, std::thread::hardware_concurrency());
+  Print(numbers);
 }
@@ -1,113 +1,601 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
-template <typename T, typename Comparator = std::less<T>>
+const size_t kCacheLineSize = 64;
+
+template <typename T>
+struct CacheAlignedAllocator {
+  using value_type = T;
+
+  CacheAlignedAllocator() = default;
+
+  template <typename U>
+  CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+  T* allocate(size_t size) {
+    return static_cast<T*>(::operator new(
+        size * sizeof(T), std::align_val_t(kCacheLineSize)));
+  }
+
+  void deallocate(T* pointer, size_t) {
+    ::operator delete(pointer, std::align_val_t(kCacheLineSize));
+  }
+
+  template <typename U>
+  bool operator==(const CacheAlignedAllocator<U>&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const CacheAlignedAllocator<U>&) const {
+    return false;
+  }
+};
+
+/*  Arity is the number of children of a node (2, 4, 8). Elements are stored
+ *   with an offset of Arity - 1 slots in a cache-line aligned array, so the
+ *   children of every node start at a multiple of Arity: for 4-ary int64 or
+ *   8-ary int32 heaps all children lie in one cache line. SiftDown then reads
+ *   one line per level over log_Arity(n) levels.
+ */
+
+template <typename T, typename Comparator = std::less<T>, size_t Arity = 2>
 class BinaryHeap {
  public:
-  void Insert(const T& elem) {
-    ++requests_counter_;
-    ++heap_size_;
+  // Stable identifier of an inserted element, valid until it is extracted.
+  using Handle = size_t;
+
+  Handle Insert(const T& elem) {
+    Handle handle = AllocateHandle();
 
-    heap_elements_[heap_size_ - 1] = elem;
-    elem_position_for_request_[requests_counter_ - 1] = heap_size_ - 1;
-    request_number_for_position_[heap_size_ - 1] = requests_counter_ - 1;
+    heap_elements_.push_back(elem);
+    handle_for_position_.push_back(handle);
+    position_for_handle_[handle] = heap_size_;
+    ++heap_size_;
 
     SiftUp(heap_size_ - 1);
+    return handle;
+  }
+
+  // Appends all elements at once. When they are at least as many as the
+  // elements already stored, the heap is rebuilt bottom-up by Floyd's
+  // algorithm in O(n), otherwise every element is sifted up.
+  std::vector<Handle> InsertMany(const std::vector<T>& elems) {
+    size_t old_size = heap_size_;
+    std::vector<Handle> handles(elems.size());
+
+    heap_elements_.reserve(heap_elements_.size() + elems.size());
+    handle_for_position_.reserve(handle_for_position_.size() + elems.size());
+    for (size_t i = 0; i < elems.size(); ++i) {
+      handles[i] = AllocateHandle();
+      heap_elements_.push_back(elems[i]);
+      handle_for_position_.push_back(handles[i]);
+      position_for_handle_[handles[i]] = heap_size_;
+      ++heap_size_;
+    }
+
+    if (elems.size() >= old_size) {
+      for (size_t i = heap_size_ / Arity + 1; i > 0; --i) {
+        SiftDown(i - 1);
+      }
+    } else {
+      for (size_t i = old_size; i < heap_size_; ++i) {
+        SiftUp(i);
+      }
+    }
+
+    return handles;
+  }
+
+  // Extracts min(k, Size()) minimal elements in ascending order.
+  std::vector<T> ExtractTopK(size_t k) {
+    k = std::min(k, heap_size_);
+
+    std::vector<T> top;
+    top.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+      top.push_back(GetMin());
+      ExtractMin();
+    }
+
+    return top;
   }
 
   void ExtractMin() {
-    ++requests_counter_;
-
-    std::swap(heap_elements_[0], heap_elements_[heap_size_ - 1]);
-    std::swap(
-        elem_position_for_request_[request_number_for_position_[0]],
-        elem_position_for_request_[request_number_for_position_[heap_size_ -
-                                                                1]]);
-    std::swap(request_number_for_position_[0],
-              request_number_for_position_[heap_size_ - 1]);
+    SwapPositions(0, heap_size_ - 1);
+    free_handles_.push_back(handle_for_position_.back());
+
+    heap_elements_.pop_back();
+    handle_for_position_.pop_back();
     --heap_size_;
 
     SiftDown(0);
   }
 
-  void DecreaseKey(size_t index, const T& delta) {
-    ++requests_counter_;
-
-    heap_elements_[elem_position_for_request_[index - 1]] -= delta;
-    SiftUp(elem_position_for_request_[index - 1]);
+  void DecreaseKey(Handle handle, const T& delta) {
+    Element(position_for_handle_[handle]) -= delta;
+    SiftUp(position_for_handle_[handle]);
   }
 
-  const T& GetMin() const {
-    ++requests_counter_;
+  const T& GetMin() const { return Element(0); }
 
-    return heap_elements_[0];
-  }
+  size_t Size() const { return heap_size_; }
+
+  bool Empty() const { return heap_size_ == 0; }
 
  private:
-  const int32_t kMaxRequestsNum = 1000000;
-  const int32_t kMaxHeapSize = 100000;
+  static_assert(Arity >= 2, "Heap arity must be at least 2");
+  static constexpr size_t kPadding = Arity - 1;
 
-  std::vector<T> heap_elements_ = std::vector<T>(kMaxHeapSize);
-  mutable std::vector<int32_t> elem_position_for_request_ =
-      std::vector<int32_t>(kMaxRequestsNum, -1);
-  mutable std::vector<int32_t> request_number_for_position_ =
-      std::vector<int32_t>(kMaxHeapSize, -1);
+  std::vector<T, CacheAlignedAllocator<T>> heap_elements_ =
+      std::vector<T, CacheAlignedAllocator<T>>(kPadding);
+  std::vector<Handle> handle_for_position_;
+  std::vector<size_t> position_for_handle_;
+  std::vector<Handle> free_handles_;
 
-  mutable size_t requests_counter_ = 0;
   size_t heap_size_ = 0;
   Comparator compare_;
 
+  Handle AllocateHandle() {
+    if (free_handles_.empty()) {
+      position_for_handle_.push_back(0);
+      return position_for_handle_.size() - 1;
+    }
+
+    Handle handle = free_handles_.back();
+    free_handles_.pop_back();
+    return handle;
+  }
+
+  T& Element(size_t index) { return heap_elements_[index + kPadding]; }
+
+  const T& Element(size_t index) const {
+    return heap_elements_[index + kPadding];
+  }
+
+  void SwapPositions(size_t first, size_t second) {
+    std::swap(Element(first), Element(second));
+    std::swap(position_for_handle_[handle_for_position_[first]],
+              position_for_handle_[handle_for_position_[second]]);
+    std::swap(handle_for_position_[first], handle_for_position_[second]);
+  }
+
   void SiftUp(size_t index) {
     while (index > 0 &&
-           compare_(heap_elements_[index], heap_elements_[(index - 1) / 2])) {
-      std::swap(heap_elements_[index], heap_elements_[(index - 1) / 2]);
-      std::swap(
-          elem_position_for_request_[request_number_for_position_[index]],
-          elem_position_for_request_[request_number_for_position_[(index - 1) /
-                                                                  2]]);
-      std::swap(request_number_for_position_[index],
-                request_number_for_position_[(index - 1) / 2]);
-      index = (index - 1) / 2;
+           compare_(Element(index), Element((index - 1) / Arity))) {
+      SwapPositions(index, (index - 1) / Arity);
+      index = (index - 1) / Arity;
     }
   }
 
   void SiftDown(size_t index) {
-    size_t left_child_index = 2 * index + 1;
-    size_t right_child_index = 2 * index + 2;
-    size_t index_to_swap = index;
+    size_t first_child_index = Arity * index + 1;
 
-    while (left_child_index < heap_size_) {
-      if (compare_(heap_elements_[left_child_index], heap_elements_[index])) {
-        index_to_swap = left_child_index;
-      }
+    while (first_child_index < heap_size_) {
+      size_t last_child_index = std::min(first_child_index + Arity, heap_size_);
+      size_t index_to_swap = first_child_index;
 
-      if ((right_child_index < heap_size_) &&
-          (compare_(heap_elements_[right_child_index],
-                    heap_elements_[left_child_index])) &&
-          (compare_(heap_elements_[right_child_index],
-                    heap_elements_[index]))) {
-        index_to_swap = right_child_index;
+      for (size_t child = first_child_index + 1; child < last_child_index;
+           ++child) {
+        if (compare_(Element(child), Element(index_to_swap))) {
+          index_to_swap = child;
+        }
       }
 
-      if (index_to_swap == index) {
+      if (!compare_(Element(index_to_swap), Element(index))) {
         break;
       }
 
-      std::swap(heap_elements_[index], heap_elements_[index_to_swap]);
-      std::swap(elem_position_for_request_[request_number_for_position_[index]],
-                elem_position_for_request_
-                    [request_number_for_position_[index_to_swap]]);
-      std::swap(request_number_for_position_[index],
-                request_number_for_position_[index_to_swap]);
+      SwapPositions(index, index_to_swap);
       index = index_to_swap;
-      left_child_index = 2 * index + 1;
-      right_child_index = 2 * index + 2;
+      first_child_index = Arity * index + 1;
+    }
+  }
+};
+
+/*  PairingHeap: same interface as BinaryHeap. Nodes live in a growable pool
+ *   and are linked as leftmost child / right sibling; prev is the parent for
+ *   a leftmost child and the left sibling otherwise. Insert and DecreaseKey
+ *   are O(1) (cut the subtree and meld it with the root), ExtractMin is
+ *   amortized O(log n) by two-pass pairing of the root children.
+ */
+
+template <typename T, typename Comparator = std::less<T>>
+class PairingHeap {
+ public:
+  using Handle = size_t;
+
+  Handle Insert(const T& elem) {
+    Handle handle = AllocateNode(elem);
+    root_ = (root_ == kNone) ? handle : Meld(root_, handle);
+    ++heap_size_;
+
+    return handle;
+  }
+
+  void ExtractMin() {
+    Handle old_root = root_;
+
+    pairing_buffer_.clear();
+    for (Handle child = nodes_[old_root].child; child != kNone;) {
+      Handle next = nodes_[child].sibling;
+      nodes_[child].prev = kNone;
+      nodes_[child].sibling = kNone;
+      pairing_buffer_.push_back(child);
+      child = next;
+    }
+
+    size_t pairs_number = 0;
+    for (size_t i = 0; i < pairing_buffer_.size(); i += 2) {
+      pairing_buffer_[pairs_number++] =
+          (i + 1 < pairing_buffer_.size())
+              ? Meld(pairing_buffer_[i], pairing_buffer_[i + 1])
+              : pairing_buffer_[i];
+    }
+
+    root_ = kNone;
+    for (size_t i = pairs_number; i > 0; --i) {
+      root_ = (root_ == kNone) ? pairing_buffer_[i - 1]
+                               : Meld(pairing_buffer_[i - 1], root_);
+    }
+
+    free_handles_.push_back(old_root);
+    --heap_size_;
+  }
+
+  void DecreaseKey(Handle handle, const T& delta) {
+    nodes_[handle].value -= delta;
+    if (handle == root_) {
+      return;
+    }
+
+    Node& node = nodes_[handle];
+    if (nodes_[node.prev].child == handle) {
+      nodes_[node.prev].child = node.sibling;
+    } else {
+      nodes_[node.prev].sibling = node.sibling;
+    }
+    if (node.sibling != kNone) {
+      nodes_[node.sibling].prev = node.prev;
+    }
+    node.prev = kNone;
+    node.sibling = kNone;
+
+    root_ = Meld(root_, handle);
+  }
+
+  const T& GetMin() const { return nodes_[root_].value; }
+
+  size_t Size() const { return heap_size_; }
+
+  bool Empty() const { return heap_size_ == 0; }
+
+ private:
+  static constexpr Handle kNone = static_cast<Handle>(-1);
+
+  struct Node {
+    T value;
+    Handle child = kNone;
+    Handle sibling = kNone;
+    Handle prev = kNone;
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<Handle> free_handles_;
+  std::vector<Handle> pairing_buffer_;
+
+  Handle root_ = kNone;
+  size_t heap_size_ = 0;
+  Comparator compare_;
+
+  Handle AllocateNode(const T& elem) {
+    if (free_handles_.empty()) {
+      nodes_.push_back(Node{elem});
+      return nodes_.size() - 1;
+    }
+
+    Handle handle = free_handles_.back();
+    free_handles_.pop_back();
+    nodes_[handle] = Node{elem};
+    return handle;
+  }
+
+  // Both arguments are roots without siblings, returns the new root.
+  Handle Meld(Handle first, Handle second) {
+    if (compare_(nodes_[second].value, nodes_[first].value)) {
+      std::swap(first, second);
+    }
+
+    nodes_[second].sibling = nodes_[first].child;
+    if (nodes_[first].child != kNone) {
+      nodes_[nodes_[first].child].prev = second;
     }
+    nodes_[second].prev = first;
+    nodes_[first].child = second;
+
+    return first;
   }
 };
 
+/*  RadixHeap: monotone heap for integer keys with the same interface.
+ *   Inserted and decreased keys must not be less than the last extracted
+ *   minimum (Dijkstra-like workloads), general 2С streams violate this.
+ *   A key lives in bucket bit_width(key ^ last), where last is the last
+ *   extracted minimum, so bucket 0 holds keys equal to it. Insert and
+ *   DecreaseKey are O(1), ExtractMin redistributes the first non-empty bucket
+ *   and every key moves to a lower bucket at most bit_width(T) times.
+ */
+
+template <typename T>
+class RadixHeap {
+  static_assert(std::is_integral_v<T>, "RadixHeap needs integer keys");
+
+ public:
+  using Handle = size_t;
+
+  Handle Insert(const T& elem) {
+    Handle handle = AllocateNode(elem);
+    PushToBucket(handle);
+    UpdateMin(elem);
+    ++heap_size_;
+
+    return handle;
+  }
+
+  void ExtractMin() {
+    if (buckets_[0].empty()) {
+      Redistribute();
+    }
+
+    free_handles_.push_back(buckets_[0].back());
+    buckets_[0].pop_back();
+    --heap_size_;
+
+    if (!buckets_[0].empty() || heap_size_ == 0) {
+      return;
+    }
+
+    size_t bucket = FirstNonEmptyBucket();
+    min_ = nodes_[buckets_[bucket][0]].value;
+    for (Handle handle : buckets_[bucket]) {
+      UpdateMin(nodes_[handle].value);
+    }
+  }
+
+  void DecreaseKey(Handle handle, const T& delta) {
+    RemoveFromBucket(handle);
+    nodes_[handle].value -= delta;
+    PushToBucket(handle);
+    UpdateMin(nodes_[handle].value);
+  }
+
+  const T& GetMin() const { return min_; }
+
+  size_t Size() const { return heap_size_; }
+
+  bool Empty() const { return heap_size_ == 0; }
+
+ private:
+  using Key = std::make_unsigned_t<T>;
+
+  static constexpr size_t kBucketsNumber = 8 * sizeof(T) + 1;
+  static constexpr Key kSignBit =
+      std::is_signed_v<T> ? static_cast<Key>(~(Key(-1) >> 1)) : Key(0);
+
+  struct Node {
+    T value;
+    size_t bucket = 0;
+    size_t index_in_bucket = 0;
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<Handle> free_handles_;
+  std::vector<std::vector<Handle>> buckets_ =
+      std::vector<std::vector<Handle>>(kBucketsNumber);
+
+  Key last_ = 0;
+  T min_ = T();
+  size_t heap_size_ = 0;
+
+  // Order-preserving map of signed keys to unsigned ones.
+  static Key ToKey(const T& value) {
+    return static_cast<Key>(value) ^ kSignBit;
+  }
+
+  static size_t BitWidth(Key key) {
+    const int kLongLongBits = 64;
+    return key == 0 ? 0
+                    : kLongLongBits - __builtin_clzll(
+                                          static_cast<unsigned long long>(key));
+  }
+
+  Handle AllocateNode(const T& elem) {
+    if (free_handles_.empty()) {
+      nodes_.push_back(Node{elem});
+      return nodes_.size() - 1;
+    }
+
+    Handle handle = free_handles_.back();
+    free_handles_.pop_back();
+    nodes_[handle] = Node{elem};
+    return handle;
+  }
+
+  void UpdateMin(const T& value) {
+    if (heap_size_ == 0 || value < min_) {
+      min_ = value;
+    }
+  }
+
+  void PushToBucket(Handle handle) {
+    Node& node = nodes_[handle];
+    node.bucket = BitWidth(ToKey(node.value) ^ last_);
+    node.index_in_bucket = buckets_[node.bucket].size();
+    buckets_[node.bucket].push_back(handle);
+  }
+
+  void RemoveFromBucket(Handle handle) {
+    std::vector<Handle>& bucket = buckets_[nodes_[handle].bucket];
+    size_t index = nodes_[handle].index_in_bucket;
+
+    bucket[index] = bucket.back();
+    nodes_[bucket[index]].index_in_bucket = index;
+    bucket.pop_back();
+  }
+
+  size_t FirstNonEmptyBucket() const {
+    size_t bucket = 0;
+    while (buckets_[bucket].empty()) {
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  void Redistribute() {
+    size_t bucket = FirstNonEmptyBucket();
+    last_ = ToKey(min_);
+
+    std::vector<Handle> moved;
+    moved.swap(buckets_[bucket]);
+    for (Handle handle : moved) {
+      PushToBucket(handle);
+    }
+  }
+};
+
+/*         MultiQueue
+*  Relaxed concurrent priority queue made of shards_per_thread * threads
+*  BinaryHeap shards, each guarded by a spin lock. Push goes to a random
+*  shard, TryPop compares the cached minima of two random shards and takes
+*  the smaller one. Pops are not linearizable: with m shards the expected
+*  rank of a popped element among all stored ones is O(m) and O(m log m)
+*  with high probability (two-choice analysis of Alistarh et al.).
+*  T must be trivially copyable, the cached minima are atomics.
+*  Usage:
+*   Creation:
+*    MultiQueue<T> queue(threads_number);
+*   Operations (thread-safe):
+*    queue.Push(value)
+*    queue.TryPop(result)  // false if every shard is empty
+*/
+
+template <typename T, typename Comparator = std::less<T>>
+class MultiQueue {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "MultiQueue caches shard minima in std::atomic<T>");
+
+ public:
+  explicit MultiQueue(size_t threads_number, size_t shards_per_thread = 2)
+      : shards_number_(std::max<size_t>(1, threads_number * shards_per_thread)),
+        shards_(new Shard[shards_number_]) {}
+
+  void Push(const T& value) {
+    Shard& shard = LockRandomShard();
+
+    shard.heap.Insert(value);
+    UpdateTop(shard);
+    shard.lock.clear(std::memory_order_release);
+  }
+
+  bool TryPop(T& result) {
+    while (true) {
+      size_t first = RandomShard();
+      size_t second = RandomShard();
+      bool first_empty = shards_[first].empty.load(std::memory_order_relaxed);
+      bool second_empty =
+          shards_[second].empty.load(std::memory_order_relaxed);
+
+      if (first_empty && second_empty) {
+        if (AllShardsEmpty()) {
+          return false;
+        }
+        continue;
+      }
+
+      size_t chosen = first;
+      if (first_empty ||
+          (!second_empty &&
+           compare_(shards_[second].top.load(std::memory_order_relaxed),
+                    shards_[first].top.load(std::memory_order_relaxed)))) {
+        chosen = second;
+      }
+
+      Shard& shard = shards_[chosen];
+      if (shard.lock.test_and_set(std::memory_order_acquire)) {
+        continue;
+      }
+
+      if (shard.heap.Empty()) {
+        shard.lock.clear(std::memory_order_release);
+        continue;
+      }
+
+      result = shard.heap.GetMin();
+      shard.heap.ExtractMin();
+      UpdateTop(shard);
+      shard.lock.clear(std::memory_order_release);
+      return true;
+    }
+  }
+
+ private:
+  struct alignas(kCacheLineSize) Shard {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::atomic<bool> empty = true;
+    std::atomic<T> top = T();
+    BinaryHeap<T, Comparator> heap;
+  };
+
+  size_t shards_number_;
+  std::unique_ptr<Shard[]> shards_;
+  Comparator compare_;
+
+  size_t RandomShard() const {
+    thread_local std::mt19937_64 generator(std::random_device{}());
+    return generator() % shards_number_;
+  }
+
+  Shard& LockRandomShard() {
+    while (true) {
+      Shard& shard = shards_[RandomShard()];
+      if (!shard.lock.test_and_set(std::memory_order_acquire)) {
+        return shard;
+      }
+    }
+  }
+
+  // Called under the shard lock.
+  void UpdateTop(Shard& shard) {
+    if (!shard.heap.Empty()) {
+      shard.top.store(shard.heap.GetMin(), std::memory_order_relaxed);
+    }
+    shard.empty.store(shard.heap.Empty(), std::memory_order_relaxed);
+  }
+
+  bool AllShardsEmpty() const {
+    for (size_t i = 0; i < shards_number_; ++i) {
+      if (!shards_[i].empty.load(std::memory_order_acquire)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <typename Heap>
 void Comands(size_t requests_number) {
-  BinaryHeap<int64_t> heap;
+  Heap heap;
+  // decreaseKey addresses elements by the number of the insert request.
+  std::vector<typename Heap::Handle> handle_for_request(requests_number);
   for (size_t i = 0; i < requests_number; ++i) {
     std::string request_type;
     int32_t param1;
@@ -118,11 +606,11 @@ void Comands(size_t requests_number) {
     if (request_type == "insert") {
       std::cin >> param1;
 
-      heap.Insert(param1);
+      handle_for_request[i] = heap.Insert(param1);
     } else if (request_type == "decreaseKey") {
       std::cin >> param1 >> param2;
 
-      heap.DecreaseKey(param1, param2);
+      heap.DecreaseKey(handle_for_request[param1 - 1], param2);
     } else if (request_type == "extractMin") {
       heap.ExtractMin();
     } else {
@@ -131,6 +619,155 @@ void Comands(size_t requests_number) {
   }
 }
 
+/*  Benchmark (compile with -DHEAP_BENCHMARK): fills a heap with random keys,
+ *   decreases half of them and extracts everything, reporting the time of
+ *   every phase for every backend. The second run is decreaseKey-heavy: four
+ *   decreases per element. Keys stay above zero, so the run is monotone and
+ *   valid for RadixHeap. Small random deltas rarely move an element, so the
+ *   Dijkstra-like run below is the one where decreaseKey really sifts.
+ */
+
+template <typename Heap>
+void BenchmarkHeap(const std::string& name, size_t elements_number,
+                   size_t decreases_per_element) {
+  using Clock = std::chrono::steady_clock;
+
+  const int64_t kMaxKey = 1000000000;
+  const int64_t kMaxDelta = 1000;
+
+  std::mt19937_64 generator(elements_number);
+
+  Heap heap;
+  std::vector<typename Heap::Handle> handles;
+
+  auto elapsed = [](Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+  };
+
+  auto start = Clock::now();
+  for (size_t i = 0; i < elements_number; ++i) {
+    handles.push_back(
+        heap.Insert(kMaxKey + static_cast<int64_t>(generator() % kMaxKey)));
+  }
+  double insert_time = elapsed(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < elements_number * decreases_per_element; ++i) {
+    heap.DecreaseKey(handles[generator() % elements_number],
+                     static_cast<int64_t>(generator() % kMaxDelta));
+  }
+  double decrease_time = elapsed(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < elements_number; ++i) {
+    heap.ExtractMin();
+  }
+  double extract_time = elapsed(start);
+
+  std::cout << name << ": insert " << insert_time << " ms, decreaseKey "
+            << decrease_time << " ms, extractMin " << extract_time << " ms\n";
+}
+
+// Dijkstra-like run: every extraction is followed by decreases of random
+// live elements to just above the extracted minimum, so decreased elements
+// travel to the top of the heap. The element index is kept in the low bits
+// of its key to know which element was extracted; keys never go below the
+// last extracted one, so the run is valid for RadixHeap.
+template <typename Heap>
+void BenchmarkDijkstraLike(const std::string& name, size_t elements_number,
+                           size_t decreases_per_extract) {
+  using Clock = std::chrono::steady_clock;
+
+  const int kIndexBits = 20;
+  const int64_t kIndexMask = (int64_t{1} << kIndexBits) - 1;
+  const int64_t kMaxPriority = int64_t{1} << 30;
+  const int64_t kNearRange = 1024;
+
+  std::mt19937_64 generator(elements_number);
+
+  Heap heap;
+  std::vector<typename Heap::Handle> handles;
+  std::vector<int64_t> priorities(elements_number);
+  std::vector<size_t> live(elements_number);
+  std::vector<size_t> live_position(elements_number);
+
+  for (size_t i = 0; i < elements_number; ++i) {
+    priorities[i] = kMaxPriority + static_cast<int64_t>(generator() %
+                                                        kMaxPriority);
+    handles.push_back(heap.Insert((priorities[i] << kIndexBits) |
+                                  static_cast<int64_t>(i)));
+    live[i] = i;
+    live_position[i] = i;
+  }
+
+  auto start = Clock::now();
+  size_t decreases = 0;
+  for (size_t extracted = 0; extracted < elements_number; ++extracted) {
+    int64_t top = heap.GetMin();
+    heap.ExtractMin();
+
+    size_t index = static_cast<size_t>(top & kIndexMask);
+    live[live_position[index]] = live.back();
+    live_position[live.back()] = live_position[index];
+    live.pop_back();
+
+    for (size_t i = 0; i < decreases_per_extract && !live.empty(); ++i) {
+      size_t element = live[generator() % live.size()];
+      int64_t target = (top >> kIndexBits) + 1 +
+                       static_cast<int64_t>(generator() % kNearRange);
+      if (target < priorities[element]) {
+        heap.DecreaseKey(handles[element],
+                         (priorities[element] - target) << kIndexBits);
+        priorities[element] = target;
+        ++decreases;
+      }
+    }
+  }
+  double total_time =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  std::cout << name << ": dijkstra-like " << total_time << " ms ("
+            << elements_number << " extractMin, " << decreases
+            << " decreaseKey)\n";
+}
+
+// Every thread alternates Push and TryPop, the queue is prefilled so pops
+// rarely meet empty shards. Reports millions of operations per second.
+void BenchmarkMultiQueue(size_t threads_number, size_t operations_per_thread) {
+  using Clock = std::chrono::steady_clock;
+
+  const int64_t kMaxKey = 1000000000;
+
+  MultiQueue<int64_t> queue(threads_number);
+  std::mt19937_64 generator(threads_number);
+  for (size_t i = 0; i < operations_per_thread; ++i) {
+    queue.Push(static_cast<int64_t>(generator() % kMaxKey));
+  }
+
+  auto start = Clock::now();
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < threads_number; ++thread) {
+    threads.emplace_back([&queue, operations_per_thread, thread] {
+      std::mt19937_64 local_generator(thread);
+      int64_t value;
+      for (size_t i = 0; i < operations_per_thread; ++i) {
+        queue.Push(static_cast<int64_t>(local_generator() % kMaxKey));
+        queue.TryPop(value);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::cout << "multiqueue, " << threads_number << " threads: "
+            << 2.0 * threads_number * operations_per_thread / seconds / 1e6
+            << " Mops/s\n";
+}
+
 void StreamSpedUp() {
   std::ios_base::sync_with_stdio(false);
   std::cin.tie(nullptr);
@@ -138,10 +775,52 @@ void StreamSpedUp() {
 }
 
 int main() {
+#ifdef HEAP_BENCHMARK
+  const size_t kBenchmarkSize = 1000000;
+
+  for (size_t decreases_per_element : {0, 4}) {
+    std::cout << "decreaseKey per element: " << decreases_per_element << '\n';
+    BenchmarkHeap<BinaryHeap<int64_t>>("binary", kBenchmarkSize,
+                                       decreases_per_element);
+    BenchmarkHeap<BinaryHeap<int64_t, std::less<int64_t>, 4>>(
+        "4-ary", kBenchmarkSize, decreases_per_element);
+    BenchmarkHeap<BinaryHeap<int64_t, std::less<int64_t>, 8>>(
+        "8-ary", kBenchmarkSize, decreases_per_element);
+    BenchmarkHeap<PairingHeap<int64_t>>("pairing", kBenchmarkSize,
+                                        decreases_per_element);
+    BenchmarkHeap<RadixHeap<int64_t>>("radix", kBenchmarkSize,
+                                      decreases_per_element);
+  }
+
+  const size_t kDecreasesPerExtract = 4;
+  std::cout << "dijkstra-like, decreaseKey per extractMin: "
+            << kDecreasesPerExtract << '\n';
+  BenchmarkDijkstraLike<BinaryHeap<int64_t>>("binary", kBenchmarkSize,
+                                             kDecreasesPerExtract);
+  BenchmarkDijkstraLike<BinaryHeap<int64_t, std::less<int64_t>, 4>>(
+      "4-ary", kBenchmarkSize, kDecreasesPerExtract);
+  BenchmarkDijkstraLike<BinaryHeap<int64_t, std::less<int64_t>, 8>>(
+      "8-ary", kBenchmarkSize, kDecreasesPerExtract);
+  BenchmarkDijkstraLike<PairingHeap<int64_t>>("pairing", kBenchmarkSize,
+                                              kDecreasesPerExtract);
+  BenchmarkDijkstraLike<RadixHeap<int64_t>>("radix", kBenchmarkSize,
+                                            kDecreasesPerExtract);
+
+  const size_t kOperationsPerThread = 1000000;
+  size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  // Powers of two and the thread count itself, which may not be one.
+  for (size_t threads_number = 1; threads_number < max_threads;
+       threads_number *= 2) {
+    BenchmarkMultiQueue(threads_number, kOperationsPerThread);
+  }
+  BenchmarkMultiQueue(max_threads, kOperationsPerThread);
+  return 0;
+#endif
+
   StreamSpedUp();
 
   size_t requests_number;
   std::cin >> requests_number;
 
-  Comands(requests_number);
+  Comands<BinaryHeap<int64_t>>(requests_number);
 }
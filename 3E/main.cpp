@@ -1,40 +1,96 @@
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <string_view>
 #include <vector>
 
-bool IsAnagram(const std::string& string1, const std::string& string2) {
-  if (string1.size() > string2.size()) {
-    return false;
+namespace Sizes {
+// Any byte may appear in the strings, not only 'a'..'z'.
+const size_t kAlphSize = 256;
+}  // namespace Sizes
+
+// balance_[c] is the count of c in the pattern minus its count in the
+// window, mismatches_ is the number of symbols with non-zero balance. The
+// window is an anagram of the pattern exactly when mismatches_ is zero, and
+// every shift changes two balances, so it is checked in O(1).
+class AnagramWindow {
+ public:
+  explicit AnagramWindow(std::string_view pattern) {
+    for (const auto& symbol : pattern) {
+      Change(symbol, 1);
+    }
   }
 
-  const size_t kAlphSize = 26;
-  const char kFirstSymbol = 'a';
+  void Push(char symbol) {
+    Change(symbol, -1);
+  }
 
-  std::vector<int32_t> string1_symbols(kAlphSize);
-  std::vector<int32_t> string2_window_symbols(kAlphSize);
+  void Pop(char symbol) {
+    Change(symbol, 1);
+  }
 
-  for (size_t i = 0; i < string1.size(); ++i) {
-    ++string1_symbols[string1[i] - kFirstSymbol];
-    ++string2_window_symbols[string2[i] - kFirstSymbol];
+  bool IsAnagram() const {
+    return mismatches_ == 0;
   }
 
-  size_t left_ptr = 0;
-  size_t right_ptr = string1.size() - 1;
+ private:
+  void Change(char symbol, int32_t delta) {
+    int32_t& balance = balance_[static_cast<unsigned char>(symbol)];
+    mismatches_ -= static_cast<size_t>(balance != 0);
+    balance += delta;
+    mismatches_ += static_cast<size_t>(balance != 0);
+  }
 
-  while (right_ptr < string2.size()) {
-    if (string1_symbols == string2_window_symbols) {
-      return true;
-    }
+  std::array<int32_t, Sizes::kAlphSize> balance_{};
+  size_t mismatches_ = 0;
+};
 
-    --string2_window_symbols[string2[left_ptr++] - kFirstSymbol];
+// Calls visitor(position) for every position of text where an anagram of
+// pattern starts, in increasing order, until the visitor returns false.
+template <typename Visitor>
+void ForEachAnagram(std::string_view pattern, std::string_view text,
+                    Visitor visitor) {
+  if (pattern.size() > text.size()) {
+    return;
+  }
 
-    if (right_ptr < string2.size() - 1) {
-      ++string2_window_symbols[string2[++right_ptr] - kFirstSymbol];
-    } else {
-      ++right_ptr;
+  AnagramWindow window(pattern);
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    window.Push(text[i]);
+  }
+  if (window.IsAnagram() && !visitor(size_t{0})) {
+    return;
+  }
+
+  for (size_t right = pattern.size(); right < text.size(); ++right) {
+    window.Push(text[right]);
+    window.Pop(text[right - pattern.size()]);
+    if (window.IsAnagram() && !visitor(right - pattern.size() + 1)) {
+      return;
     }
   }
+}
 
-  return false;
+std::vector<size_t> FindAnagrams(std::string_view pattern,
+                                 std::string_view text) {
+  std::vector<size_t> positions;
+  ForEachAnagram(pattern, text,
+                 [&positions](size_t position) {
+                   positions.push_back(position);
+                   return true;
+                 });
+  return positions;
+}
+
+// Stops at the first match.
+bool IsAnagram(const std::string& string1, const std::string& string2) {
+  bool found = false;
+  ForEachAnagram(string1, string2, [&found](size_t) {
+    found = true;
+    return false;
+  });
+  return found;
 }
 
 void InOutSpeedUp() {